@@ -179,192 +179,283 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
 }
 
 boolean PubSubClient::connect(const char *id, const char *user, const char *pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage, boolean cleanSession) {
-    if (!connected()) {
-        int result = 0;
+    if (connected()) {
+        return true;
+    }
+    if (!startConnect(id,user,pass,willTopic,willQos,willRetain,willMessage,cleanSession)) {
+        return false;
+    }
+    int rc;
+    while ((rc = connectStep()) == MQTT_CONNECTING) {
+        yield();
+    }
+    return rc == MQTT_CONNECTED;
+}
 
+boolean PubSubClient::startConnect(const char *id) {
+    return startConnect(id,NULL,NULL,0,0,0,0,1);
+}
 
-        if(_client->connected()) {
-            result = 1;
-        } else {
-            if (domain != NULL) {
-                result = _client->connect(this->domain, this->port);
-            } else {
-                result = _client->connect(this->ip, this->port);
-            }
-        }
+boolean PubSubClient::startConnect(const char *id, const char *user, const char *pass) {
+    return startConnect(id,user,pass,0,0,0,0,1);
+}
 
-        if (result == 1) {
-            nextMsgId = 1;
-            // Leave room in the buffer for header and variable length field
-            uint16_t length = MQTT_MAX_HEADER_SIZE;
-            unsigned int j;
+boolean PubSubClient::startConnect(const char *id, const char *user, const char *pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage, boolean cleanSession) {
+    if (this->connectPhase != MQTT_PHASE_IDLE) {
+        return false;
+    }
+    // Leave room in the buffer for header and variable length field
+    uint16_t length = MQTT_MAX_HEADER_SIZE;
+    unsigned int j;
 
 #if MQTT_VERSION == MQTT_VERSION_3_1
-            uint8_t d[9] = {0x00,0x06,'M','Q','I','s','d','p', MQTT_VERSION};
+    uint8_t d[9] = {0x00,0x06,'M','Q','I','s','d','p', MQTT_VERSION};
 #define MQTT_HEADER_VERSION_LENGTH 9
 #elif MQTT_VERSION == MQTT_VERSION_3_1_1
-            uint8_t d[7] = {0x00,0x04,'M','Q','T','T',MQTT_VERSION};
+    uint8_t d[7] = {0x00,0x04,'M','Q','T','T',MQTT_VERSION};
 #define MQTT_HEADER_VERSION_LENGTH 7
 #endif
-            for (j = 0;j<MQTT_HEADER_VERSION_LENGTH;j++) {
-                this->buffer[length++] = d[j];
-            }
-
-            uint8_t v;
-            if (willTopic) {
-                v = 0x04|(willQos<<3)|(willRetain<<5);
-            } else {
-                v = 0x00;
-            }
-            if (cleanSession) {
-                v = v|0x02;
-            }
+    for (j = 0;j<MQTT_HEADER_VERSION_LENGTH;j++) {
+        this->buffer[length++] = d[j];
+    }
 
-            if(user != NULL) {
-                v = v|0x80;
+    uint8_t v;
+    if (willTopic) {
+        v = 0x04|(willQos<<3)|(willRetain<<5);
+    } else {
+        v = 0x00;
+    }
+    if (cleanSession) {
+        v = v|0x02;
+    }
 
-                if(pass != NULL) {
-                    v = v|(0x80>>1);
-                }
-            }
-            this->buffer[length++] = v;
-
-            this->buffer[length++] = ((this->keepAlive) >> 8);
-            this->buffer[length++] = ((this->keepAlive) & 0xFF);
-
-            CHECK_STRING_LENGTH(length,id)
-            length = writeString(id,this->buffer,length);
-            if (willTopic) {
-                CHECK_STRING_LENGTH(length,willTopic)
-                length = writeString(willTopic,this->buffer,length);
-                CHECK_STRING_LENGTH(length,willMessage)
-                length = writeString(willMessage,this->buffer,length);
-            }
+    if(user != NULL) {
+        v = v|0x80;
 
-            if(user != NULL) {
-                CHECK_STRING_LENGTH(length,user)
-                length = writeString(user,this->buffer,length);
-                if(pass != NULL) {
-                    CHECK_STRING_LENGTH(length,pass)
-                    length = writeString(pass,this->buffer,length);
-                }
-            }
+        if(pass != NULL) {
+            v = v|(0x80>>1);
+        }
+    }
+    this->buffer[length++] = v;
+
+    this->buffer[length++] = ((this->keepAlive) >> 8);
+    this->buffer[length++] = ((this->keepAlive) & 0xFF);
+
+    CHECK_STRING_LENGTH(length,id)
+    length = writeString(id,this->buffer,length);
+    if (willTopic) {
+        CHECK_STRING_LENGTH(length,willTopic)
+        length = writeString(willTopic,this->buffer,length);
+        CHECK_STRING_LENGTH(length,willMessage)
+        length = writeString(willMessage,this->buffer,length);
+    }
 
-            write(MQTTCONNECT,this->buffer,length-MQTT_MAX_HEADER_SIZE);
+    if(user != NULL) {
+        CHECK_STRING_LENGTH(length,user)
+        length = writeString(user,this->buffer,length);
+        if(pass != NULL) {
+            CHECK_STRING_LENGTH(length,pass)
+            length = writeString(pass,this->buffer,length);
+        }
+    }
 
-            lastInActivity = lastOutActivity = millis();
+    // The packet stays in the buffer until the send phase has written all of it
+    uint8_t hlen = buildHeader(MQTTCONNECT,this->buffer,length-MQTT_MAX_HEADER_SIZE);
+    this->connectOffset = MQTT_MAX_HEADER_SIZE-hlen;
+    this->connectLength = length-this->connectOffset;
+    this->connectSent = 0;
+    this->packetLength = 0;
+    this->packetReceived = 0;
+    this->connectPhase = MQTT_PHASE_TCP;
+    this->connectPhaseStart = millis();
+    _state = MQTT_CONNECTING;
+    return true;
+}
 
-            while (!_client->available()) {
-                unsigned long t = millis();
-                if (t-lastInActivity >= ((int32_t) this->socketTimeout*1000UL)) {
-                    _state = MQTT_CONNECTION_TIMEOUT;
-                    _client->stop();
-                    return false;
-                }
+int PubSubClient::connectStep() {
+    unsigned long t = millis();
+    unsigned long timeout = this->socketTimeout*1000UL;
+    switch (this->connectPhase) {
+    case MQTT_PHASE_TCP: {
+        int result = 0;
+        if(_client->connected()) {
+            result = 1;
+        } else if (domain != NULL) {
+            result = _client->connect(this->domain, this->port);
+        } else {
+            result = _client->connect(this->ip, this->port);
+        }
+        if (result != 1) {
+            return abortConnect(MQTT_CONNECT_FAILED);
+        }
+        nextMsgId = 1;
+        this->connectPhase = MQTT_PHASE_SEND;
+        this->connectPhaseStart = millis();
+        break;
+    }
+    case MQTT_PHASE_SEND: {
+        uint16_t remaining = this->connectLength-this->connectSent;
+#ifdef MQTT_MAX_TRANSFER_SIZE
+        if (remaining > MQTT_MAX_TRANSFER_SIZE) {
+            remaining = MQTT_MAX_TRANSFER_SIZE;
+        }
+#endif
+        this->connectSent += _client->write(this->buffer+this->connectOffset+this->connectSent,remaining);
+        if (this->connectSent < this->connectLength) {
+            if (!_client->connected()) {
+                return abortConnect(MQTT_CONNECT_FAILED);
             }
-            uint8_t llen;
-            uint32_t len = readPacket(&llen);
-
-            if (len == 4) {
-                if (buffer[3] == 0) {
-                    lastInActivity = millis();
-                    pingOutstanding = false;
-                    _state = MQTT_CONNECTED;
-                    return true;
-                } else {
-                    _state = buffer[3];
-                }
+            if (t-this->connectPhaseStart >= timeout) {
+                return abortConnect(MQTT_CONNECTION_TIMEOUT);
             }
-            _client->stop();
-        } else {
-            _state = MQTT_CONNECT_FAILED;
+            break;
         }
-        return false;
+        lastInActivity = lastOutActivity = t;
+        this->connectPhase = MQTT_PHASE_CONNACK;
+        this->connectPhaseStart = t;
+        break;
     }
-    return true;
+    case MQTT_PHASE_CONNACK: {
+        uint8_t llen;
+        uint32_t len = readPacket(&llen);
+        if (len == 0) {
+            // CONNACK not complete yet
+            if (!_client->connected() && !_client->available()) {
+                return abortConnect(MQTT_CONNECT_FAILED);
+            }
+            if (t-this->connectPhaseStart >= timeout) {
+                return abortConnect(MQTT_CONNECTION_TIMEOUT);
+            }
+            break;
+        }
+        if (len == 4 && (this->buffer[0]&0xF0) == MQTTCONNACK) {
+            if (buffer[3] == 0) {
+                this->connectPhase = MQTT_PHASE_IDLE;
+                lastInActivity = millis();
+                pingOutstanding = false;
+                _state = MQTT_CONNECTED;
+                return _state;
+            }
+            return abortConnect(buffer[3]);
+        }
+        return abortConnect(MQTT_CONNECT_FAILED);
+    }
+    default:
+        break;
+    }
+    return _state;
 }
 
-// reads a byte into result
-boolean PubSubClient::readByte(uint8_t * result) {
-   uint32_t previousMillis = millis();
-   while(!_client->available()) {
-     yield();
-     uint32_t currentMillis = millis();
-     if(currentMillis - previousMillis >= ((int32_t) this->socketTimeout * 1000)){
-       return false;
-     }
-   }
-   *result = _client->read();
-   return true;
-}
-
-// reads a byte into result[*index] and increments index
-boolean PubSubClient::readByte(uint8_t * result, uint16_t * index){
-  uint16_t current_index = *index;
-  uint8_t * write_address = &(result[current_index]);
-  if(readByte(write_address)){
-    *index = current_index + 1;
-    return true;
-  }
-  return false;
+int PubSubClient::abortConnect(int state) {
+    this->connectPhase = MQTT_PHASE_IDLE;
+    _state = state;
+    _client->stop();
+    return _state;
 }
 
-uint32_t PubSubClient::readPacket(uint8_t* lengthLength) {
-    uint16_t len = 0;
-    if(!readByte(this->buffer, &len)) return 0;
-    bool isPublish = (this->buffer[0]&0xF0) == MQTTPUBLISH;
-    uint32_t multiplier = 1;
-    uint32_t length = 0;
-    uint8_t digit = 0;
-    uint16_t skip = 0;
-    uint32_t start = 0;
+boolean PubSubClient::connecting() {
+    return this->connectPhase != MQTT_PHASE_IDLE;
+}
 
-    do {
-        if (len == 5) {
-            // Invalid remaining length encoding - kill the connection
-            _state = MQTT_DISCONNECTED;
-            _client->stop();
-            return 0;
-        }
-        if(!readByte(&digit)) return 0;
-        this->buffer[len++] = digit;
-        length += (digit & 127) * multiplier;
-        multiplier <<=7; //multiplier *= 128
-    } while ((digit & 128) != 0);
-    *lengthLength = len-1;
-
-    if (isPublish) {
-        // Read in topic length to calculate bytes to skip over for Stream writing
-        if(!readByte(this->buffer, &len)) return 0;
-        if(!readByte(this->buffer, &len)) return 0;
-        skip = (this->buffer[*lengthLength+1]<<8)+this->buffer[*lengthLength+2];
-        start = 2;
-        if (this->buffer[0]&MQTTQOS1) {
-            // skip message id
-            skip += 2;
-        }
+// Writes the publish payload part of newly received bytes to the stream.
+// data holds n bytes that start at packet offset pos
+void PubSubClient::streamPayload(const uint8_t* data, uint32_t pos, size_t n) {
+    uint8_t llen = this->packetLengthLength;
+    if (!this->stream || (this->buffer[0]&0xF0) != MQTTPUBLISH || this->packetReceived < (uint32_t)llen+3) {
+        return;
+    }
+    uint32_t payloadStart = llen+3+((this->buffer[llen+1]<<8)+this->buffer[llen+2]);
+    if (this->buffer[0]&MQTTQOS1) {
+        // skip message id
+        payloadStart += 2;
     }
-    uint32_t idx = len;
+    if (pos+n <= payloadStart) {
+        return;
+    }
+    if (pos < payloadStart) {
+        data += payloadStart-pos;
+        n -= payloadStart-pos;
+    }
+    this->stream->write(data,n);
+}
 
-    for (uint32_t i = start;i<length;i++) {
-        if(!readByte(&digit)) return 0;
-        if (this->stream) {
-            if (isPublish && idx-*lengthLength-2>skip) {
-                this->stream->write(digit);
+// Reads whatever is available of the current packet in chunks. Partial packets are kept in the
+// buffer and resumed on the next call, so this never waits for the network.
+// Returns the number of packet bytes in the buffer once the packet is complete, or 0 while it is
+// still incomplete, when it is too large to buffer without a stream, or on a malformed header
+uint32_t PubSubClient::readPacket(uint8_t* lengthLength) {
+    int avail;
+    while ((avail = _client->available()) > 0) {
+        uint32_t received = this->packetReceived;
+        if (this->packetLength == 0) {
+            // Fixed header: read up to the next remaining length byte, then parse it from the buffer
+            uint32_t need = (received == 0) ? 2 : 1;
+            int n = _client->read(this->buffer+received,min((uint32_t)avail,need));
+            if (n <= 0) {
+                return 0;
+            }
+            received += n;
+            this->packetReceived = received;
+            if (received < 2 || (this->buffer[received-1] & 128) != 0) {
+                if (received == 5) {
+                    // Invalid remaining length encoding - kill the connection
+                    this->packetReceived = 0;
+                    _state = MQTT_DISCONNECTED;
+                    _client->stop();
+                    return 0;
+                }
+                continue;
+            }
+            uint32_t length = 0;
+            uint32_t multiplier = 1;
+            for (uint32_t i = 1;i<received;i++) {
+                length += (this->buffer[i] & 127) * multiplier;
+                multiplier <<=7; //multiplier *= 128
+            }
+            this->packetLengthLength = received-1;
+            this->packetLength = received+length;
+        } else {
+            // Body: fill the buffer, then drain whatever does not fit
+            uint32_t remaining = this->packetLength-received;
+            int n;
+            if (received < this->bufferSize) {
+                uint32_t room = min(remaining,(uint32_t)(this->bufferSize-received));
+                n = _client->read(this->buffer+received,min((uint32_t)avail,room));
+                if (n > 0) {
+                    this->packetReceived = received+n;
+                    streamPayload(this->buffer+received,received,n);
+                }
+            } else {
+                uint8_t overflow[32];
+                n = _client->read(overflow,min((uint32_t)avail,min(remaining,(uint32_t)sizeof(overflow))));
+                if (n > 0) {
+                    this->packetReceived = received+n;
+                    streamPayload(overflow,received,n);
+                }
+            }
+            if (n <= 0) {
+                return 0;
             }
         }
-
-        if (len < this->bufferSize) {
-            this->buffer[len] = digit;
-            len++;
+        if (this->packetLength != 0 && this->packetReceived == this->packetLength) {
+            break;
         }
-        idx++;
+    }
+    if (this->packetLength == 0 || this->packetReceived < this->packetLength) {
+        return 0;
     }
 
-    if (!this->stream && idx > this->bufferSize) {
-        len = 0; // This will cause the packet to be ignored.
+    uint32_t length = this->packetLength;
+    *lengthLength = this->packetLengthLength;
+    this->packetLength = 0;
+    this->packetReceived = 0;
+    if (length > this->bufferSize) {
+        if (!this->stream) {
+            return 0; // This will cause the packet to be ignored.
+        }
+        return this->bufferSize;
     }
-    return len;
+    return length;
 }
 
 boolean PubSubClient::loop() {
@@ -658,6 +749,7 @@ boolean PubSubClient::unsubscribe(const char* topic) {
 }
 
 void PubSubClient::disconnect() {
+    this->connectPhase = MQTT_PHASE_IDLE;
     this->buffer[0] = MQTTDISCONNECT;
     this->buffer[1] = 0;
     _client->write(this->buffer,2);
@@ -0,0 +1,93 @@
+# 把 web/ 目录下的网页压缩为 gzip 并生成 src/web_assets.h（PROGMEM 数组 + 强 ETag）
+# Gzip the pages in web/ into src/web_assets.h (PROGMEM arrays + strong ETags)
+#
+# PlatformIO 在每次编译前通过 extra_scripts 自动运行；也可以手动运行：python scripts/build_web_assets.py
+# Runs automatically before every PlatformIO build via extra_scripts; can also be run by hand: python scripts/build_web_assets.py
+
+import gzip
+import hashlib
+import os
+
+# 文件名 -> (资源ID, 请求路径, Content-Type) / File name -> (asset id, request path, Content-Type)
+ASSETS = [
+    ("index.html", "WEB_ASSET_INDEX", "/", "text/html; charset=utf-8"),
+    ("ota.html", "WEB_ASSET_OTA", "/ota", "text/html; charset=utf-8"),
+    ("clients.html", "WEB_ASSET_CLIENTS", "/clients", "text/html; charset=utf-8"),
+]
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO 注入 / Injected by PlatformIO
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB_DIR = os.path.join(PROJECT_DIR, "web")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "web_assets.h")
+
+
+def c_array(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def render():
+    out = [
+        "// 由 scripts/build_web_assets.py 根据 web/ 目录生成，请勿手动修改",
+        "// Generated by scripts/build_web_assets.py from web/, do not edit",
+        "#pragma once",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "struct WebAsset {",
+        "  const char* path; // 请求路径 / Request path",
+        "  const char* contentType;",
+        "  const uint8_t* data; // gzip 压缩后的内容（PROGMEM） / Gzipped content (PROGMEM)",
+        "  size_t length;",
+        "  const char* etag; // 内容哈希，带引号 / Content hash, quoted",
+        "};",
+        "",
+    ]
+    entries = []
+    for name, asset_id, path, content_type in ASSETS:
+        with open(os.path.join(WEB_DIR, name), "rb") as f:
+            raw = f.read()
+        # mtime=0 保证相同内容生成相同字节 / mtime=0 keeps the output byte-identical for identical input
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(raw).hexdigest()[:16]
+        symbol = asset_id + "_GZ"
+        out.append("// %s: %d -> %d 字节 / bytes" % (name, len(raw), len(packed)))
+        out.append("static const uint8_t %s[] PROGMEM = {" % symbol)
+        out.append(c_array(packed))
+        out.append("};")
+        out.append("")
+        entries.append((asset_id, path, content_type, symbol, etag))
+
+    out.append("enum WebAssetId {")
+    for asset_id, *_ in entries:
+        out.append("  %s," % asset_id)
+    out.append("  WEB_ASSET_COUNT")
+    out.append("};")
+    out.append("")
+    out.append("static const WebAsset WEB_ASSETS[WEB_ASSET_COUNT] = {")
+    for asset_id, path, content_type, symbol, etag in entries:
+        out.append('  {"%s", "%s", %s, sizeof(%s), "\\"%s\\""},' % (path, content_type, symbol, symbol, etag))
+    out.append("};")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    text = render()
+    # 内容未变化时不重写，避免触发重新编译 / Leave the file alone when unchanged so it does not trigger a rebuild
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, "r", encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    print("web_assets.h updated")
+
+
+main()
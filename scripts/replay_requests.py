@@ -0,0 +1,73 @@
+# 向设备重放一组录制的请求，然后打印每个路由的耗时和堆占用（需要用 nodemcuv2_profile 环境编译的固件）
+# Replay a recorded request mix against a device, then print time and heap use per route (needs firmware built with
+# the nodemcuv2_profile environment)
+#
+# 用法 / Usage: python scripts/replay_requests.py <设备IP / device IP> [请求文件 / mix file] [--rounds N]
+#
+# 请求文件每行一个请求：<方法> <路径> [请求体]，# 开头为注释；默认使用 scripts/request_mix.txt
+# The mix file holds one request per line: <method> <path> [body]; lines starting with # are comments. Defaults to
+# scripts/request_mix.txt
+
+import argparse
+import http.client
+import json
+import os
+import time
+
+
+def load_mix(path):
+    requests = []
+    with open(path, "r", encoding="utf-8") as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            parts = line.split(" ", 2)
+            method, target = parts[0].upper(), parts[1]
+            body = parts[2].encode("utf-8") if len(parts) > 2 else None
+            requests.append((method, target, body))
+    return requests
+
+
+def fetch_json(conn, target):
+    conn.request("GET", target)
+    response = conn.getresponse()
+    return json.loads(response.read())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a request mix and report per-route statistics")
+    parser.add_argument("host")
+    parser.add_argument("mix", nargs="?", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "request_mix.txt"))
+    parser.add_argument("--rounds", type=int, default=10)
+    args = parser.parse_args()
+
+    requests = load_mix(args.mix)
+    # 长连接复用，避免把握手时间算进来 / Reuse one connection so handshakes do not skew the numbers
+    conn = http.client.HTTPConnection(args.host, 80, timeout=10)
+    fetch_json(conn, "/api/route_stats?reset=1")  # 清零 / Clear
+
+    failed = 0
+    started = time.monotonic()
+    for _ in range(args.rounds):
+        for method, target, body in requests:
+            conn.request(method, target, body=body)
+            response = conn.getresponse()
+            response.read()
+            if response.status >= 400:
+                failed += 1
+            if response.getheader("Connection", "").lower() == "close":
+                conn.close()
+                conn = http.client.HTTPConnection(args.host, 80, timeout=10)
+    elapsed = time.monotonic() - started
+
+    stats = fetch_json(conn, "/api/route_stats")
+    total = args.rounds * len(requests)
+    print("%d requests in %.2f s, %d failed, free heap %d bytes" % (total, elapsed, failed, stats["freeHeap"]))
+    print("%-28s %7s %8s %8s %9s %9s" % ("route", "calls", "avg us", "max us", "heap peak", "heap held"))
+    for route in sorted(stats["routes"], key=lambda r: -r["maxUs"]):
+        print("%-28s %7d %8d %8d %9d %9d" % (route["uri"], route["calls"], route["avgUs"], route["maxUs"],
+                                             route["heapPeak"], route["heapHeld"]))
+
+
+main()
@@ -0,0 +1,1261 @@
+// 事件驱动的非阻塞HTTP服务器 / Event-driven non-blocking HTTP server
+#include "http_server.h"
+
+extern "C" {
+#include <lwip/tcp.h>
+}
+#ifdef HTTP_SERVER_PROFILE
+#include <umm_malloc/umm_malloc.h>
+#endif
+
+// 字段类型：打包在 Connection::fields 中 / Field types packed into Connection::fields
+#define FIELD_URI 'u'
+#define FIELD_ARG 'a'
+#define FIELD_HEADER 'h'
+
+#define HTTP_SERVER_BOUNCE_SIZE 256 // PROGMEM 复制到栈上的中转缓冲区 / Stack bounce buffer for PROGMEM copies
+#define HTTP_SERVER_SEGMENT_SIZE 256 // RAM 输出段的最小容量 / Minimum capacity of a RAM output segment
+
+// 编译期检查：最大允许的 127 条路由也能在常量求值限制内建表 / Compile-time check: the largest allowed table of 127
+// routes still builds within the constant evaluation limits
+static constexpr bool routeTableBuildsAtLimit() {
+  constexpr size_t count = 127;
+  char uris[count][12] = {};
+  HttpRoute routes[count] = {};
+  for (size_t i = 0; i < count; i++) {
+    const char prefix[] = "/api/r";
+    for (size_t k = 0; k < sizeof(prefix) - 1; k++) uris[i][k] = prefix[k];
+    uris[i][6] = '0' + i / 100;
+    uris[i][7] = '0' + i / 10 % 10;
+    uris[i][8] = '0' + i % 10;
+    routes[i] = {uris[i], HTTP_GET, nullptr, nullptr};
+  }
+  HttpRouteTable<count> table(routes);
+  return table.SLOTS == 256;
+}
+static_assert(routeTableBuildsAtLimit(), "route table must build with 127 routes");
+
+volatile bool* HttpServer::_wakeFlag = nullptr;
+
+HttpServer::HttpServer(uint16_t port) : _port(port) {
+  memset(_conns, 0, sizeof(_conns));
+}
+
+void HttpServer::begin() {
+  if (_listener) return;
+  tcp_pcb* pcb = tcp_new();
+  if (!pcb) return;
+  if (tcp_bind(pcb, IP_ADDR_ANY, _port) != ERR_OK) {
+    tcp_close(pcb);
+    return;
+  }
+  _listener = tcp_listen(pcb);
+  if (!_listener) {
+    tcp_close(pcb);
+    return;
+  }
+  tcp_arg(_listener, this);
+  tcp_accept(_listener, onAccept);
+}
+
+void HttpServer::stop() {
+  for (Connection& c : _conns) {
+    if (c.state != CONN_FREE) closeConnection(c, true);
+  }
+  if (_listener) {
+    tcp_arg(_listener, nullptr);
+    tcp_accept(_listener, nullptr);
+    tcp_close(_listener);
+    _listener = nullptr;
+  }
+}
+
+void HttpServer::on(const char* uri, THandlerFunction handler) {
+  on(uri, HTTP_ANY, handler, nullptr);
+}
+
+void HttpServer::on(const char* uri, HTTPMethod method, THandlerFunction handler) {
+  on(uri, method, handler, nullptr);
+}
+
+void HttpServer::on(const char* uri, HTTPMethod method, THandlerFunction handler, THandlerFunction uploadHandler) {
+  if (_routeCount >= HTTP_SERVER_MAX_ROUTES) return;
+  Route& r = _routes[_routeCount++];
+  r.uri = uri;
+  r.method = method;
+  r.handler = handler;
+  r.uploadHandler = uploadHandler;
+}
+
+void HttpServer::addHook(RequestHook hook) {
+  _hook = hook;
+}
+
+void HttpServer::setAdmission(AdmissionFilter filter) {
+  _admission = filter;
+}
+
+void HttpServer::collectHeaders(const char* headerKeys[], size_t count) {
+  _collectedCount = 0;
+  for (size_t i = 0; i < count && i < HTTP_SERVER_MAX_COLLECTED_HEADERS; i++) {
+    _collected[_collectedCount++] = headerKeys[i];
+  }
+}
+
+// =============================
+// lwIP 回调（SYS上下文，只记录数据和状态） / lwIP callbacks (SYS context, record data and state only)
+// =============================
+err_t HttpServer::onAccept(void* arg, tcp_pcb* pcb, err_t err) {
+  HttpServer* server = static_cast<HttpServer*>(arg);
+  if (err != ERR_OK || !pcb || !server) return ERR_VAL;
+  Connection* c = server->allocConnection();
+  if (!c && server->evictIdleConnection()) c = server->allocConnection();
+  if (!c) {
+    server->_stats.rejected++;
+    tcp_abort(pcb); // 连接数已满 / Connection limit reached
+    return ERR_ABRT;
+  }
+  server->_stats.accepted++;
+  if (_wakeFlag) *_wakeFlag = true;
+  c->pcb = pcb;
+  c->state = CONN_HEAD;
+  c->lastProgress = millis();
+  tcp_arg(pcb, c);
+  tcp_recv(pcb, onRecv);
+  tcp_err(pcb, onError);
+  tcp_nagle_disable(pcb);
+  return ERR_OK;
+}
+
+err_t HttpServer::onRecv(void* arg, tcp_pcb* pcb, pbuf* p, err_t err) {
+  Connection* c = static_cast<Connection*>(arg);
+  if (!c) {
+    if (p) {
+      tcp_recved(pcb, p->tot_len);
+      pbuf_free(p);
+    }
+    return ERR_OK;
+  }
+  if (_wakeFlag) *_wakeFlag = true; // 数据或FIN都需要主循环处理 / Data and FIN both need the main loop
+  if (!p) {
+    c->peerClosed = true; // 对端发送了FIN / The peer sent FIN
+    return ERR_OK;
+  }
+  // 先不确认，由 loop() 处理后再调用 tcp_recved()，以此实现流控 / Not acknowledged yet: loop() calls tcp_recved() once processed, which gives flow control
+  c->rxUnacked += p->tot_len;
+  if (c->rx) {
+    pbuf_cat(c->rx, p);
+  } else {
+    c->rx = p;
+  }
+  c->lastProgress = millis();
+  return ERR_OK;
+}
+
+void HttpServer::onError(void* arg, err_t err) {
+  Connection* c = static_cast<Connection*>(arg);
+  if (!c) return;
+  c->pcb = nullptr; // lwIP 已释放 pcb / lwIP already freed the pcb
+  c->peerClosed = true;
+}
+
+// =============================
+// 连接管理 / Connection management
+// =============================
+HttpServer::Connection* HttpServer::allocConnection() {
+  for (Connection& c : _conns) {
+    if (c.state == CONN_FREE) {
+      uint8_t generation = c.generation;
+      memset(&c, 0, sizeof(c));
+      c.generation = generation + 1;
+      c.route = -1;
+      return &c;
+    }
+  }
+  return nullptr;
+}
+
+// 槽位已满时关闭最久未活动的空闲长连接 / With all slots busy, close the persistent connection idle the longest
+bool HttpServer::evictIdleConnection() {
+  Connection* oldest = nullptr;
+  for (Connection& c : _conns) {
+    bool idle = c.state == CONN_HEAD && c.requests > 0 && c.headLen == 0 && !c.outHead && rxAvailable(c) == 0;
+    if (idle && (!oldest || (long)(c.lastProgress - oldest->lastProgress) < 0)) oldest = &c;
+  }
+  if (!oldest) return false;
+  closeConnection(*oldest);
+  _stats.evicted++;
+  return true;
+}
+
+uint8_t HttpServer::openConnections() const {
+  uint8_t n = 0;
+  for (const Connection& c : _conns) {
+    if (c.state != CONN_FREE) n++;
+  }
+  return n;
+}
+
+void HttpServer::closeConnection(Connection& c, bool abort) {
+  if (c.pcb) {
+    tcp_arg(c.pcb, nullptr);
+    tcp_recv(c.pcb, nullptr);
+    tcp_err(c.pcb, nullptr);
+    // 确认全部已收数据，避免 lwIP 因未读数据回复RST / Acknowledge everything received so lwIP does not answer with RST over unread data
+    while (c.rxUnacked > 0) {
+      uint16_t n = c.rxUnacked > 0xFFFF ? 0xFFFF : c.rxUnacked;
+      tcp_recved(c.pcb, n);
+      c.rxUnacked -= n;
+    }
+    if (abort || tcp_close(c.pcb) != ERR_OK) tcp_abort(c.pcb);
+    c.pcb = nullptr;
+  }
+  if (c.rx) {
+    pbuf_free(c.rx);
+    c.rx = nullptr;
+  }
+  freeOutput(c);
+  resetRequest(c);
+  c.state = CONN_FREE;
+}
+
+// 释放一个请求占用的内存，连接本身保留 / Free the memory held by one request, keeping the connection
+void HttpServer::resetRequest(Connection& c) {
+  free(c.head);
+  free(c.fields);
+  free(c.body);
+  free(c.delimiter);
+  delete c.upload;
+  c.head = nullptr;
+  c.headLen = 0;
+  c.fields = nullptr;
+  c.fieldsLen = 0;
+  c.body = nullptr;
+  c.bodyLen = 0;
+  c.delimiter = nullptr;
+  c.upload = nullptr;
+  c.contentLength = 0;
+  c.bodyReceived = 0;
+  c.route = -1;
+  c.formBody = false;
+  c.keepAlive = false;
+  c.responseStarted = false;
+  c.chunked = false;
+  c.responseComplete = false;
+}
+
+// 请求处理完毕：长连接回到等待请求头，否则只释放请求内存，等响应发完后关闭
+// The request is done: a persistent connection goes back to waiting for a head, otherwise only the request memory is
+// freed and the connection closes once the response is out
+void HttpServer::finishRequest(Connection& c) {
+  if (c.keepAlive && c.responseComplete) {
+    resetRequest(c);
+    c.requests++;
+    c.state = CONN_HEAD;
+    return;
+  }
+  free(c.head);
+  c.head = nullptr;
+  free(c.body);
+  c.body = nullptr;
+}
+
+void HttpServer::handleClient() {
+  for (Connection& c : _conns) {
+    if (c.state == CONN_FREE) continue;
+    advance(c);
+  }
+}
+
+// 推进一个连接的有限切片 / Advance one connection by a bounded slice
+void HttpServer::advance(Connection& c) {
+  if (!c.pcb) {
+    closeConnection(c); // 连接出错，lwIP 已释放 / The connection failed and lwIP freed it
+    return;
+  }
+  pump(c);
+
+  size_t budget = HTTP_SERVER_SLICE_BYTES;
+  switch (c.state) {
+    case CONN_HEAD:
+      // 流水线请求等前一个响应全部交给 lwIP 后再处理 / A pipelined request waits until the previous response is handed to lwIP
+      if (c.outHead) break;
+      // 跳过请求之间多余的空行 / Skip stray empty lines between requests
+      while (c.headLen == 0 && rxAvailable(c) > 0) {
+        char ch;
+        rxPeek(c, &ch, 1);
+        if (ch != '\r' && ch != '\n') break;
+        rxConsume(c, 1);
+      }
+      if (readHead(c, budget)) {
+        if (parseHead(c)) {
+          startBody(c);
+        } else {
+          sendError(c, 400);
+        }
+      }
+      break;
+    case CONN_BODY:
+      readBody(c, budget);
+      break;
+    case CONN_UPLOAD:
+      readUpload(c, budget);
+      break;
+    case CONN_DISCARD:
+      discardBody(c, budget);
+      break;
+    case CONN_STREAM:
+      // 流连接不再接收请求，收到的数据直接丢弃 / A stream takes no further requests, incoming data is dropped
+      rxConsume(c, rxAvailable(c));
+      break;
+    default:
+      break;
+  }
+  pump(c);
+
+  if (!c.pcb) {
+    closeConnection(c);
+    return;
+  }
+  if (c.state == CONN_RESPONDING && !c.outHead) {
+    closeConnection(c); // 响应已全部交给 lwIP / The whole response is handed to lwIP
+    return;
+  }
+  if (c.state == CONN_STREAM) {
+    if (c.peerClosed) closeConnection(c);
+    return;
+  }
+  bool idle = c.state == CONN_HEAD && c.headLen == 0 && !c.outHead && rxAvailable(c) == 0;
+  if (idle && c.peerClosed) {
+    closeConnection(c);
+    return;
+  }
+  if (idle && c.requests > 0) {
+    // 长连接两次请求之间 / A persistent connection between requests
+    if (millis() - c.lastProgress > HTTP_SERVER_IDLE_TIMEOUT_MS) {
+      closeConnection(c);
+      _stats.idleClosed++;
+    }
+    return;
+  }
+  if (millis() - c.lastProgress > HTTP_SERVER_TIMEOUT_MS) {
+    closeConnection(c, true); // 请求或响应停滞 / Request or response stalled
+  }
+}
+
+// =============================
+// 接收缓冲 / Receive buffer
+// =============================
+size_t HttpServer::rxAvailable(const Connection& c) const {
+  return c.rx ? c.rx->tot_len - c.rxOffset : 0;
+}
+
+size_t HttpServer::rxPeek(const Connection& c, void* dst, size_t length) const {
+  if (!c.rx) return 0;
+  size_t avail = rxAvailable(c);
+  if (length > avail) length = avail;
+  return pbuf_copy_partial(c.rx, dst, length, c.rxOffset);
+}
+
+// 丢掉已处理的数据并向 lwIP 确认，打开接收窗口 / Drop processed data and acknowledge it to lwIP, reopening the window
+void HttpServer::rxConsume(Connection& c, size_t length) {
+  if (length == 0) return;
+  size_t avail = rxAvailable(c);
+  if (length > avail) length = avail;
+  c.rxOffset += length;
+  while (c.rx && c.rxOffset >= c.rx->len) {
+    pbuf* next = c.rx->next;
+    c.rxOffset -= c.rx->len;
+    if (next) pbuf_ref(next);
+    pbuf_free(c.rx);
+    c.rx = next;
+  }
+  if (c.pcb) tcp_recved(c.pcb, length);
+  c.rxUnacked -= length;
+  c.lastProgress = millis();
+}
+
+// =============================
+// 请求解析 / Request parsing
+// =============================
+// 把数据复制到请求头缓冲区，找到空行为止；只消费属于请求头的字节 / Copy data into the head buffer up to the empty line; only head bytes are consumed
+bool HttpServer::readHead(Connection& c, size_t& budget) {
+  while (budget > 0 && rxAvailable(c) > 0) {
+    if (!c.head) {
+      c.head = (char*)malloc(HTTP_SERVER_MAX_HEAD + 1);
+      if (!c.head) {
+        closeConnection(c, true);
+        return false;
+      }
+    }
+    size_t room = HTTP_SERVER_MAX_HEAD - c.headLen;
+    if (room == 0) {
+      sendError(c, 431);
+      return false;
+    }
+    size_t n = rxAvailable(c);
+    if (n > room) n = room;
+    if (n > budget) n = budget;
+    rxPeek(c, c.head + c.headLen, n);
+    size_t oldLen = c.headLen;
+    size_t newLen = oldLen + n;
+    size_t end = 0;
+    for (size_t i = oldLen >= 3 ? oldLen - 3 : 0; i + 4 <= newLen; i++) {
+      if (memcmp(c.head + i, "\r\n\r\n", 4) == 0) {
+        end = i + 4;
+        break;
+      }
+    }
+    // 请求头按C字符串解析，含NUL字节的请求直接拒绝；只检查空行之前的字节，之后的请求体可以是二进制 / The head is parsed
+    // as a C string, so a NUL byte rejects the request; only bytes before the blank line are checked, the body after it
+    // may be binary
+    size_t headEnd = end ? end : newLen;
+    if (memchr(c.head + oldLen, '\0', headEnd - oldLen)) {
+      sendError(c, 400);
+      return false;
+    }
+    if (end) {
+      rxConsume(c, end - oldLen);
+      budget -= end - oldLen;
+      c.headLen = end;
+      c.head[end] = '\0';
+      return true;
+    }
+    rxConsume(c, n);
+    budget -= n;
+    c.headLen = newLen;
+  }
+  return false;
+}
+
+static HTTPMethod parseMethod(const char* s, size_t n) {
+  if (n == 3 && memcmp(s, "GET", 3) == 0) return HTTP_GET;
+  if (n == 4 && memcmp(s, "POST", 4) == 0) return HTTP_POST;
+  if (n == 4 && memcmp(s, "HEAD", 4) == 0) return HTTP_HEAD;
+  if (n == 3 && memcmp(s, "PUT", 3) == 0) return HTTP_PUT;
+  if (n == 5 && memcmp(s, "PATCH", 5) == 0) return HTTP_PATCH;
+  if (n == 6 && memcmp(s, "DELETE", 6) == 0) return HTTP_DELETE;
+  if (n == 7 && memcmp(s, "OPTIONS", 7) == 0) return HTTP_OPTIONS;
+  return HTTP_ANY; // 未知方法 / Unknown method
+}
+
+// 大小写无关地比较长度为 n 的名称 / Case-insensitive compare of a name of length n
+static bool nameEquals(const char* s, size_t n, const char* name) {
+  return strlen(name) == n && strncasecmp(s, name, n) == 0;
+}
+
+// 解析请求行和请求头，记录URI、查询参数和需要的请求头 / Parse the request line and headers; record the URI, query args and wanted headers
+bool HttpServer::parseHead(Connection& c) {
+  char* p = c.head;
+  char* lineEnd = strstr(p, "\r\n");
+  if (!lineEnd) return false;
+  char* sp1 = (char*)memchr(p, ' ', lineEnd - p);
+  if (!sp1) return false;
+  char* target = sp1 + 1;
+  char* sp2 = (char*)memchr(target, ' ', lineEnd - target);
+  if (!sp2) return false;
+  c.method = parseMethod(p, sp1 - p);
+  if (c.method == HTTP_ANY) return false;
+  // HTTP/1.1 默认保持连接，HTTP/1.0 需要显式 keep-alive / HTTP/1.1 persists by default, HTTP/1.0 needs an explicit keep-alive
+  bool http10 = lineEnd - sp2 - 1 == 8 && memcmp(sp2 + 1, "HTTP/1.0", 8) == 0;
+  c.keepAlive = !http10;
+
+  char* query = (char*)memchr(target, '?', sp2 - target);
+  char* pathEnd = query ? query : sp2;
+  addField(c, FIELD_URI, "", 0, target, pathEnd - target, true);
+  if (query) parseArgs(c, query + 1, sp2 - query - 1);
+
+  const char* contentType = nullptr;
+  size_t contentTypeLen = 0;
+  c.contentLength = 0;
+  for (char* line = lineEnd + 2; *line && !(line[0] == '\r' && line[1] == '\n');) {
+    char* end = strstr(line, "\r\n");
+    if (!end) break;
+    char* colon = (char*)memchr(line, ':', end - line);
+    if (colon) {
+      size_t nameLen = colon - line;
+      char* value = colon + 1;
+      while (value < end && *value == ' ') value++;
+      size_t valueLen = end - value;
+      if (nameEquals(line, nameLen, "Content-Length")) {
+        c.contentLength = strtoul(value, nullptr, 10);
+      } else if (nameEquals(line, nameLen, "Content-Type")) {
+        contentType = value;
+        contentTypeLen = valueLen;
+      } else if (nameEquals(line, nameLen, "Connection")) {
+        if (valueLen >= 5 && strncasecmp(value, "close", 5) == 0) c.keepAlive = false;
+        if (valueLen >= 10 && strncasecmp(value, "keep-alive", 10) == 0) c.keepAlive = true;
+      }
+      for (uint8_t i = 0; i < _collectedCount; i++) {
+        if (nameEquals(line, nameLen, _collected[i])) {
+          addField(c, FIELD_HEADER, _collected[i], strlen(_collected[i]), value, valueLen, false);
+        }
+      }
+    }
+    line = end + 2;
+  }
+
+  const char* uri = findField(c, FIELD_URI, "");
+  c.route = findRoute(uri, c.method);
+
+  if (contentType) {
+    static const char FORM[] = "application/x-www-form-urlencoded";
+    static const char MULTIPART[] = "multipart/form-data";
+    c.formBody = contentTypeLen >= sizeof(FORM) - 1 && strncasecmp(contentType, FORM, sizeof(FORM) - 1) == 0;
+    bool multipart = contentTypeLen >= sizeof(MULTIPART) - 1 && strncasecmp(contentType, MULTIPART, sizeof(MULTIPART) - 1) == 0;
+    if (multipart && hasUploadHandler(c.route)) {
+      const char* b = strstr(contentType, "boundary=");
+      if (!b || b >= contentType + contentTypeLen) return false;
+      b += 9;
+      size_t bLen = contentType + contentTypeLen - b;
+      if (bLen > 0 && b[0] == '"') {
+        b++;
+        bLen = (const char*)memchr(b, '"', bLen) ? (const char*)memchr(b, '"', bLen) - b : bLen - 1;
+      }
+      if (bLen == 0 || bLen > 70) return false;
+      c.delimiterLen = bLen + 4;
+      c.delimiter = (char*)malloc(c.delimiterLen);
+      if (!c.delimiter) return false;
+      memcpy(c.delimiter, "\r\n--", 4);
+      memcpy(c.delimiter + 4, b, bLen);
+    }
+  }
+
+  _stats.requests++;
+  if (c.requests > 0) _stats.reused++;
+  if (_hook) _hook(c.method, uri);
+  c.headLen = 0; // 请求头缓冲区之后用作行缓冲区 / The head buffer serves as the line buffer from here on
+  return true;
+}
+
+// 根据请求体决定下一步：直接分发、接收请求体或分段上传 / Decide the next step from the body: dispatch, receive it or stream the upload
+void HttpServer::startBody(Connection& c) {
+  if (c.route >= 0 && _admission) {
+    _current = &c;
+    bool admitted = _admission(c.method, findField(c, FIELD_URI, ""));
+    _current = nullptr;
+    if (!admitted) {
+      _stats.throttled++;
+      sendError(c, 429);
+      return;
+    }
+  }
+  if (c.contentLength == 0) {
+    dispatch(c);
+    return;
+  }
+  if (c.delimiter) {
+    c.upload = new HTTPUpload();
+    c.upload->contentLength = c.contentLength;
+    c.mpState = MP_DATA;
+    c.mpFilePart = false;
+    c.delimiterMatched = 2; // 请求体以 "--boundary" 开头，相当于已匹配 "\r\n" / The body starts with "--boundary", as if "\r\n" were matched
+    c.state = CONN_UPLOAD;
+    return;
+  }
+  if (c.contentLength > HTTP_SERVER_MAX_BODY) {
+    sendError(c, 413);
+    return;
+  }
+  c.body = (char*)malloc(c.contentLength + 1);
+  if (!c.body) {
+    sendError(c, 500);
+    return;
+  }
+  c.state = CONN_BODY;
+}
+
+void HttpServer::readBody(Connection& c, size_t& budget) {
+  size_t n = c.contentLength - c.bodyLen;
+  if (n > rxAvailable(c)) n = rxAvailable(c);
+  if (n > budget) n = budget;
+  rxPeek(c, c.body + c.bodyLen, n);
+  rxConsume(c, n);
+  budget -= n;
+  c.bodyLen += n;
+  if (c.bodyLen < c.contentLength) return;
+  c.body[c.bodyLen] = '\0';
+  if (c.formBody) {
+    parseArgs(c, c.body, c.bodyLen);
+  } else {
+    addField(c, FIELD_ARG, "plain", 5, c.body, c.bodyLen, false); // 与 ESP8266WebServer 一致 / Same as ESP8266WebServer
+  }
+  dispatch(c);
+}
+
+// 读取一行到行缓冲区（不含换行），返回是否读完整行 / Read one line into the line buffer (without CRLF); returns whether it is complete
+bool HttpServer::readLine(Connection& c, size_t& budget) {
+  while (budget > 0 && rxAvailable(c) > 0 && c.bodyReceived < c.contentLength) {
+    char ch;
+    rxPeek(c, &ch, 1);
+    rxConsume(c, 1);
+    budget--;
+    c.bodyReceived++;
+    if (ch == '\n') {
+      if (c.headLen > 0 && c.head[c.headLen - 1] == '\r') c.headLen--;
+      c.head[c.headLen] = '\0';
+      return true;
+    }
+    if (c.headLen < HTTP_SERVER_MAX_HEAD) c.head[c.headLen++] = ch; // 过长的行被截断 / Overlong lines are truncated
+  }
+  return false;
+}
+
+// 从 Content-Disposition 中取出 name 和 filename / Take name and filename out of Content-Disposition
+static String dispositionParam(const char* line, const char* key) {
+  const char* p = strstr(line, key);
+  if (!p) return String();
+  p += strlen(key);
+  const char* end = strchr(p, '"');
+  if (!end) return String();
+  String value;
+  value.reserve(end - p);
+  while (p < end) value += *p++;
+  return value;
+}
+
+void HttpServer::parsePartHeader(Connection& c, const char* line) {
+  if (strncasecmp(line, "Content-Disposition:", 20) == 0) {
+    c.upload->name = dispositionParam(line, "name=\"");
+    c.upload->filename = dispositionParam(line, "filename=\"");
+    c.mpFilePart = strstr(line, "filename=\"") != nullptr;
+  } else if (strncasecmp(line, "Content-Type:", 13) == 0) {
+    const char* v = line + 13;
+    while (*v == ' ') v++;
+    c.upload->type = v;
+  }
+}
+
+// 分段数据：文件写入上传缓冲区，普通字段累积到请求体缓冲区 / Part data: file bytes go to the upload buffer, plain fields accumulate in the body buffer
+void HttpServer::emitPartData(Connection& c, const char* data, size_t length) {
+  if (c.mpState != MP_DATA) return;
+  HTTPUpload& u = *c.upload;
+  if (c.mpFilePart) {
+    while (length > 0) {
+      size_t n = HTTP_UPLOAD_BUFLEN - u.currentSize;
+      if (n > length) n = length;
+      memcpy(u.buf + u.currentSize, data, n);
+      u.currentSize += n;
+      data += n;
+      length -= n;
+      if (u.currentSize == HTTP_UPLOAD_BUFLEN) callUpload(c, UPLOAD_FILE_WRITE);
+    }
+  } else if (c.body) {
+    size_t n = HTTP_SERVER_MAX_BODY - c.bodyLen;
+    if (n > length) n = length;
+    memcpy(c.body + c.bodyLen, data, n);
+    c.bodyLen += n;
+  }
+}
+
+// 调用上传处理函数；已经发出响应后不再调用 / Call the upload handler; skipped once a response went out
+void HttpServer::callUpload(Connection& c, HTTPUploadStatus status) {
+  HTTPUpload& u = *c.upload;
+  u.status = status;
+  if (status == UPLOAD_FILE_WRITE) u.totalSize += u.currentSize;
+  if (!c.responseStarted) {
+    _current = &c;
+    if (c.route < _table.count) {
+      _table.routes[c.route].uploadHandler();
+    } else {
+      _routes[c.route - _table.count].uploadHandler();
+    }
+    _current = nullptr;
+  }
+  if (status == UPLOAD_FILE_WRITE) u.currentSize = 0;
+}
+
+// 增量处理 multipart 请求体，每轮最多调用一次上传处理函数 / Incremental multipart body processing, at most one upload handler call per pass
+void HttpServer::readUpload(Connection& c, size_t& budget) {
+  HTTPUpload& u = *c.upload;
+  while (budget > 0 && c.bodyReceived < c.contentLength && rxAvailable(c) > 0) {
+    if (c.mpState == MP_AFTER_DELIM || c.mpState == MP_PART_HEADERS) {
+      if (!readLine(c, budget)) break;
+      if (c.mpState == MP_AFTER_DELIM) {
+        c.mpState = strncmp(c.head, "--", 2) == 0 ? MP_EPILOGUE : MP_PART_HEADERS;
+      } else if (c.headLen > 0) {
+        parsePartHeader(c, c.head);
+      } else {
+        // 分段头结束 / End of part headers
+        c.mpState = MP_DATA;
+        c.delimiterMatched = 0;
+        if (c.mpFilePart) {
+          u.totalSize = 0;
+          u.currentSize = 0;
+          callUpload(c, UPLOAD_FILE_START);
+        } else if (!c.body) {
+          c.body = (char*)malloc(HTTP_SERVER_MAX_BODY);
+          c.bodyLen = 0;
+        } else {
+          c.bodyLen = 0;
+        }
+      }
+      c.headLen = 0;
+      continue;
+    }
+    if (c.mpState == MP_EPILOGUE) {
+      size_t n = c.contentLength - c.bodyReceived;
+      if (n > rxAvailable(c)) n = rxAvailable(c);
+      if (n > budget) n = budget;
+      rxConsume(c, n);
+      c.bodyReceived += n;
+      budget -= n;
+      continue;
+    }
+
+    // MP_DATA：逐字节匹配分隔符，分隔符首字符 '\r' 不会出现在 boundary 中，失配时可直接回退
+    // MP_DATA: match the delimiter byte by byte; its first character '\r' never occurs in a boundary, so a mismatch can
+    // simply fall back
+    char chunk[128];
+    size_t n = c.contentLength - c.bodyReceived;
+    if (n > sizeof(chunk)) n = sizeof(chunk);
+    if (n > budget) n = budget;
+    n = rxPeek(c, chunk, n);
+    size_t used = 0;
+    size_t runStart = 0; // 尚未输出的数据起点 / Start of data not yet emitted
+    bool delimiterFound = false;
+    bool sliceDone = false;
+    while (used < n && !delimiterFound && !sliceDone) {
+      char ch = chunk[used++];
+      if (ch == c.delimiter[c.delimiterMatched]) {
+        if (c.delimiterMatched == 0 && used - 1 > runStart) emitPartData(c, chunk + runStart, used - 1 - runStart);
+        c.delimiterMatched++;
+        runStart = used;
+        if (c.delimiterMatched == c.delimiterLen) delimiterFound = true;
+        continue;
+      }
+      if (c.delimiterMatched > 0) {
+        // 失配：已匹配的前缀属于数据 / Mismatch: the matched prefix was data
+        emitPartData(c, c.delimiter, c.delimiterMatched);
+        c.delimiterMatched = 0;
+        runStart = used - 1;
+        if (ch == c.delimiter[0]) {
+          c.delimiterMatched = 1;
+          runStart = used;
+          continue;
+        }
+      }
+      // 上传缓冲区写满时结束本轮 / End the slice once the upload buffer is full
+      if (c.mpFilePart && u.currentSize + (used - runStart) >= HTTP_UPLOAD_BUFLEN) sliceDone = true;
+    }
+    if (c.delimiterMatched == 0 && used > runStart) emitPartData(c, chunk + runStart, used - runStart);
+    rxConsume(c, used);
+    c.bodyReceived += used;
+    budget -= used;
+
+    if (delimiterFound) {
+      c.delimiterMatched = 0;
+      if (c.mpFilePart) {
+        if (u.currentSize > 0) callUpload(c, UPLOAD_FILE_WRITE);
+        callUpload(c, UPLOAD_FILE_END);
+        c.mpFilePart = false;
+      } else if (c.body && u.name.length() > 0) {
+        addField(c, FIELD_ARG, u.name.c_str(), u.name.length(), c.body, c.bodyLen, false);
+      }
+      c.mpState = MP_AFTER_DELIM;
+    }
+    if (sliceDone) break;
+  }
+
+  if (c.bodyReceived >= c.contentLength) {
+    if (c.mpState == MP_DATA && c.mpFilePart) callUpload(c, UPLOAD_FILE_ABORTED); // 缺少结束分隔符 / Closing delimiter missing
+    dispatch(c);
+  }
+}
+
+void HttpServer::discardBody(Connection& c, size_t& budget) {
+  size_t n = c.contentLength - c.bodyReceived;
+  if (n > rxAvailable(c)) n = rxAvailable(c);
+  if (n > budget) n = budget;
+  rxConsume(c, n);
+  c.bodyReceived += n;
+  budget -= n;
+  if (c.bodyReceived >= c.contentLength) c.state = CONN_RESPONDING;
+}
+
+// 查找路由：先查编译期表（一次哈希），再查 on() 注册的少量路由 / Find the route: the compile-time table first (one hash),
+// then the few routes added with on()
+int HttpServer::findRoute(const char* uri, HTTPMethod method) const {
+  int i = _table.find(uri);
+  if (i >= 0 && (_table.routes[i].method == HTTP_ANY || _table.routes[i].method == method)) return i;
+  for (uint8_t j = 0; j < _routeCount; j++) {
+    const Route& r = _routes[j];
+    if ((r.method == HTTP_ANY || r.method == method) && strcmp(r.uri, uri) == 0) return _table.count + j;
+  }
+  return -1;
+}
+
+bool HttpServer::hasUploadHandler(int route) const {
+  if (route < 0) return false;
+  if (route < _table.count) return _table.routes[route].uploadHandler != nullptr;
+  return (bool)_routes[route - _table.count].uploadHandler;
+}
+
+const char* HttpServer::routeUri(size_t route) const {
+  if (route < _table.count) return _table.routes[route].uri;
+  return route < routeCount() ? _routes[route - _table.count].uri : nullptr;
+}
+
+// 调用路由的处理函数，启用统计时记录耗时和堆占用 / Call the route's handler, recording time and heap use when profiling
+void HttpServer::callHandler(int route) {
+#ifdef HTTP_SERVER_PROFILE
+  uint32_t freeBefore = ESP.getFreeHeap();
+#if defined(UMM_STATS) || defined(UMM_STATS_FULL)
+  umm_free_heap_size_min_reset(); // 低水位从当前空闲量重新开始 / Restart the low-water mark at the current free size
+#endif
+  uint32_t start = micros();
+#endif
+  if (route < _table.count) {
+    _table.routes[route].handler();
+  } else {
+    _routes[route - _table.count].handler();
+  }
+#ifdef HTTP_SERVER_PROFILE
+  uint32_t elapsed = micros() - start;
+  uint32_t freeAfter = ESP.getFreeHeap();
+#if defined(UMM_STATS) || defined(UMM_STATS_FULL)
+  uint32_t freeMin = umm_free_heap_size_min();
+#else
+  uint32_t freeMin = freeAfter < freeBefore ? freeAfter : freeBefore; // 无低水位统计时只能看返回时 / Without low-water stats only the return point is seen
+#endif
+  if (route >= HTTP_SERVER_PROFILE_ROUTES) return;
+  RouteProfile& p = _profiles[route];
+  p.calls++;
+  p.totalUs += elapsed;
+  if (elapsed > p.maxUs) p.maxUs = elapsed;
+  if (freeMin < freeBefore && freeBefore - freeMin > p.heapPeak) p.heapPeak = freeBefore - freeMin;
+  int32_t held = (int32_t)freeBefore - (int32_t)freeAfter;
+  if (p.calls == 1 || held > p.heapHeld) p.heapHeld = held;
+#endif
+}
+
+// 运行处理函数；未找到路由时返回404 / Run the handler; 404 when no route matches
+void HttpServer::dispatch(Connection& c) {
+  c.state = CONN_RESPONDING;
+  if (c.route < 0) {
+    sendError(c, 404);
+  } else if (!c.responseStarted) {
+    _current = &c;
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+    _extraHeaders = String();
+    callHandler(c.route);
+    _current = nullptr;
+  }
+  if (c.state == CONN_RESPONDING) finishRequest(c);
+}
+
+// 直接回复错误并丢弃剩余请求体；除404外随后关闭连接 / Answer with an error directly and discard the rest of the body; the
+// connection closes afterwards except on 404
+void HttpServer::sendError(Connection& c, int code) {
+  if (code != 404) c.keepAlive = false;
+  if (!c.responseStarted) {
+    Connection* saved = _current;
+    _current = &c;
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+    _extraHeaders = String();
+    send(code, "text/plain", "");
+    _current = saved;
+  }
+  c.state = c.bodyReceived < c.contentLength && c.contentLength <= 0x100000 ? CONN_DISCARD : CONN_RESPONDING;
+  if (c.state == CONN_DISCARD) c.bodyReceived += c.bodyLen;
+}
+
+// =============================
+// 参数与请求头 / Arguments and headers
+// =============================
+static int hexValue(char ch) {
+  if (ch >= '0' && ch <= '9') return ch - '0';
+  if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+  return -1;
+}
+
+// 追加一个字段：类型字节 + 名称 + '\0' + 值 + '\0' / Append a field: type byte + name + '\0' + value + '\0'
+// 字段按C字符串打包，名称和值都截断在第一个NUL处（二进制请求体仍可从 rawBody() 完整读取）
+// Fields are packed as C strings, so names and values stop at their first NUL (a binary body is still complete in
+// rawBody())
+void HttpServer::addField(Connection& c, char type, const char* name, size_t nameLen, const char* value, size_t valueLen, bool decode) {
+  const char* nul = (const char*)memchr(name, '\0', nameLen);
+  if (nul) nameLen = nul - name;
+  size_t need = c.fieldsLen + 1 + nameLen + 1 + valueLen + 1;
+  if (need > 0xFFFF) return;
+  char* fields = (char*)realloc(c.fields, need);
+  if (!fields) return;
+  c.fields = fields;
+  char* p = fields + c.fieldsLen;
+  *p++ = type;
+  memcpy(p, name, nameLen);
+  p += nameLen;
+  *p++ = '\0';
+  for (size_t i = 0; i < valueLen; i++) {
+    char ch = value[i];
+    if (decode && ch == '+') {
+      ch = ' ';
+    } else if (decode && ch == '%' && i + 2 < valueLen) {
+      int hi = hexValue(value[i + 1]);
+      int lo = hexValue(value[i + 2]);
+      if (hi >= 0 && lo >= 0) {
+        ch = (char)(hi * 16 + lo);
+        i += 2;
+      }
+    }
+    if (ch == '\0') break;
+    *p++ = ch;
+  }
+  *p++ = '\0';
+  c.fieldsLen = p - fields;
+}
+
+// 解析 a=1&b=2 形式的参数 / Parse a=1&b=2 style arguments
+void HttpServer::parseArgs(Connection& c, const char* query, size_t length) {
+  const char* end = query + length;
+  while (query < end) {
+    const char* amp = (const char*)memchr(query, '&', end - query);
+    const char* pairEnd = amp ? amp : end;
+    const char* eq = (const char*)memchr(query, '=', pairEnd - query);
+    const char* nameEnd = eq ? eq : pairEnd;
+    if (nameEnd > query) {
+      const char* value = eq ? eq + 1 : pairEnd;
+      addField(c, FIELD_ARG, query, nameEnd - query, value, pairEnd - value, true);
+    }
+    query = pairEnd + 1;
+  }
+}
+
+const char* HttpServer::findField(const Connection& c, char type, const char* name) const {
+  const char* p = c.fields;
+  const char* end = c.fields + c.fieldsLen;
+  while (p && p < end) {
+    char t = *p++;
+    const char* n = p;
+    p += strlen(p) + 1;
+    const char* v = p;
+    p += strlen(p) + 1;
+    if (t == type && (type == FIELD_HEADER ? strcasecmp(n, name) == 0 : strcmp(n, name) == 0)) return v;
+  }
+  return nullptr;
+}
+
+HTTPMethod HttpServer::method() const {
+  return _current ? _current->method : HTTP_ANY;
+}
+
+String HttpServer::uri() const {
+  const char* v = _current ? findField(*_current, FIELD_URI, "") : nullptr;
+  return v ? String(v) : String();
+}
+
+uint32_t HttpServer::remoteIP() const {
+  return _current && _current->pcb ? ip_addr_get_ip4_u32(&_current->pcb->remote_ip) : 0;
+}
+
+String HttpServer::arg(const String& name) const {
+  const char* v = _current ? findField(*_current, FIELD_ARG, name.c_str()) : nullptr;
+  return v ? String(v) : String();
+}
+
+bool HttpServer::hasArg(const String& name) const {
+  return _current && findField(*_current, FIELD_ARG, name.c_str()) != nullptr;
+}
+
+String HttpServer::header(const String& name) const {
+  const char* v = _current ? findField(*_current, FIELD_HEADER, name.c_str()) : nullptr;
+  return v ? String(v) : String();
+}
+
+bool HttpServer::hasHeader(const String& name) const {
+  return _current && findField(*_current, FIELD_HEADER, name.c_str()) != nullptr;
+}
+
+HTTPUpload& HttpServer::upload() {
+  static HTTPUpload empty;
+  return _current && _current->upload ? *_current->upload : empty;
+}
+
+const uint8_t* HttpServer::rawBody(size_t& length) const {
+  length = 0;
+  if (!_current || !_current->body || _current->formBody || _current->upload) return nullptr;
+  length = _current->bodyLen;
+  return (const uint8_t*)_current->body;
+}
+
+// =============================
+// 响应 / Response
+// =============================
+static PGM_P statusText(int code) {
+  switch (code) {
+    case 200: return PSTR("OK");
+    case 304: return PSTR("Not Modified");
+    case 400: return PSTR("Bad Request");
+    case 404: return PSTR("Not Found");
+    case 413: return PSTR("Payload Too Large");
+    case 429: return PSTR("Too Many Requests");
+    case 431: return PSTR("Request Header Fields Too Large");
+    case 500: return PSTR("Internal Server Error");
+    case 503: return PSTR("Service Unavailable");
+    default: return PSTR("");
+  }
+}
+
+void HttpServer::sendHeader(const String& name, const String& value, bool first) {
+  String line = name;
+  line += ": ";
+  line += value;
+  line += "\r\n";
+  if (first) {
+    _extraHeaders = line + _extraHeaders;
+  } else {
+    _extraHeaders += line;
+  }
+}
+
+void HttpServer::setContentLength(size_t length) {
+  _contentLength = length;
+}
+
+// 写入状态行和响应头；长度设置为 CONTENT_LENGTH_UNKNOWN 时使用分块传输 / Write the status line and headers; CONTENT_LENGTH_UNKNOWN selects chunked transfer
+void HttpServer::writeHead(Connection& c, int code, const char* contentType, bool typeProgmem, size_t length) {
+  char line[64];
+  int n = snprintf_P(line, sizeof(line), PSTR("HTTP/1.1 %d "), code);
+  queue(c, line, n, false);
+  PGM_P text = statusText(code);
+  queue(c, text, strlen_P(text), true);
+  queue(c, "\r\n", 2, false);
+  size_t typeLen = contentType ? (typeProgmem ? strlen_P(contentType) : strlen(contentType)) : 0;
+  if (typeLen > 0) {
+    queue(c, PSTR("Content-Type: "), 14, true);
+    queue(c, contentType, typeLen, typeProgmem);
+    queue(c, "\r\n", 2, false);
+  }
+  if (_contentLength == CONTENT_LENGTH_UNKNOWN) {
+    c.chunked = true;
+    queue(c, PSTR("Transfer-Encoding: chunked\r\n"), 28, true);
+  } else {
+    n = snprintf_P(line, sizeof(line), PSTR("Content-Length: %u\r\n"),
+                   (unsigned)(_contentLength != CONTENT_LENGTH_NOT_SET ? _contentLength : length));
+    queue(c, line, n, false);
+  }
+  if (c.requests + 1 >= HTTP_SERVER_MAX_REQUESTS) c.keepAlive = false;
+  if (c.keepAlive) {
+    queue(c, PSTR("Connection: keep-alive\r\n"), 24, true);
+  } else {
+    queue(c, PSTR("Connection: close\r\n"), 19, true);
+  }
+  if (_extraHeaders.length() > 0) queue(c, _extraHeaders.c_str(), _extraHeaders.length(), false);
+  queue(c, "\r\n", 2, false);
+  c.responseStarted = true;
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+  _extraHeaders = String();
+}
+
+void HttpServer::send(int code, const char* contentType, const char* content) {
+  send(code, contentType, (const uint8_t*)content, content ? strlen(content) : 0);
+}
+
+void HttpServer::send(int code, const char* contentType, const String& content) {
+  send(code, contentType, (const uint8_t*)content.c_str(), content.length());
+}
+
+void HttpServer::send(int code, const String& contentType, const String& content) {
+  send(code, contentType.c_str(), (const uint8_t*)content.c_str(), content.length());
+}
+
+void HttpServer::send(int code, const char* contentType, const uint8_t* content, size_t length) {
+  if (!_current || _current->responseStarted) return;
+  Connection& c = *_current;
+  writeHead(c, code, contentType, false, length);
+  if (length > 0) {
+    if (c.chunked) {
+      queueChunk(c, (const char*)content, length, false);
+    } else {
+      queue(c, (const char*)content, length, false);
+    }
+  }
+  if (!c.chunked) c.responseComplete = true;
+  pump(c); // 立即交给 lwIP，处理函数随后重启也能发出 / Hand to lwIP at once so it leaves even if the handler restarts next
+}
+
+void HttpServer::send_P(int code, PGM_P contentType, PGM_P content) {
+  send_P(code, contentType, content, content ? strlen_P(content) : 0);
+}
+
+void HttpServer::send_P(int code, PGM_P contentType, PGM_P content, size_t length) {
+  if (!_current || _current->responseStarted) return;
+  Connection& c = *_current;
+  writeHead(c, code, contentType, true, length);
+  if (length > 0) {
+    if (c.chunked) {
+      queueChunk(c, content, length, true);
+    } else {
+      queue(c, content, length, true);
+    }
+  }
+  if (!c.chunked) c.responseComplete = true;
+  pump(c);
+}
+
+void HttpServer::sendContent(const String& content) {
+  sendContent(content.c_str(), content.length());
+}
+
+void HttpServer::sendContent(const char* content, size_t length) {
+  if (!_current || !_current->responseStarted) return;
+  Connection& c = *_current;
+  if (c.chunked) {
+    queueChunk(c, content, length, false); // 空内容即结束块 / Empty content is the final chunk
+  } else if (length > 0) {
+    queue(c, content, length, false);
+  }
+  pump(c);
+}
+
+void HttpServer::sendContent_P(PGM_P content) {
+  sendContent_P(content, strlen_P(content));
+}
+
+void HttpServer::sendContent_P(PGM_P content, size_t length) {
+  if (!_current || !_current->responseStarted) return;
+  Connection& c = *_current;
+  if (c.chunked) {
+    queueChunk(c, content, length, true);
+  } else if (length > 0) {
+    queue(c, content, length, true);
+  }
+  pump(c);
+}
+
+// =============================
+// 输出队列 / Output queue
+// =============================
+// RAM 数据复制进队列（尽量并入最后一段），PROGMEM 数据只记录指针
+// RAM data is copied into the queue (merged into the last segment when it fits), PROGMEM data is only referenced
+void HttpServer::queue(Connection& c, const char* data, size_t length, bool progmem) {
+  while (length > 0) {
+    size_t n = length > 0xFFFF ? 0xFFFF : length;
+    OutSegment* tail = c.outTail;
+    if (!progmem && tail && tail->capacity > 0 && tail->capacity - tail->length >= n) {
+      memcpy(tail->buf + tail->length, data, n);
+      tail->length += n;
+    } else {
+      size_t capacity = progmem ? 0 : (n > HTTP_SERVER_SEGMENT_SIZE ? n : HTTP_SERVER_SEGMENT_SIZE);
+      OutSegment* seg = (OutSegment*)malloc(sizeof(OutSegment) + capacity);
+      if (!seg) {
+        closeConnection(c, true); // 内存不足，放弃这个连接 / Out of memory, give up on this connection
+        return;
+      }
+      seg->next = nullptr;
+      seg->length = n;
+      seg->sent = 0;
+      seg->capacity = capacity;
+      if (progmem) {
+        seg->data = data;
+      } else {
+        memcpy(seg->buf, data, n);
+        seg->data = seg->buf;
+      }
+      if (tail) {
+        tail->next = seg;
+      } else {
+        c.outHead = seg;
+      }
+      c.outTail = seg;
+    }
+    data += n;
+    length -= n;
+  }
+}
+
+void HttpServer::queueChunk(Connection& c, const char* data, size_t length, bool progmem) {
+  char size[12];
+  int n = snprintf_P(size, sizeof(size), PSTR("%x\r\n"), (unsigned)length);
+  queue(c, size, n, false);
+  if (length > 0) queue(c, data, length, progmem);
+  queue(c, "\r\n", 2, false);
+  if (length == 0) c.responseComplete = true; // 结束块 / Final chunk
+}
+
+// 按发送窗口把队列交给 lwIP / Hand the queue to lwIP as far as the send window allows
+void HttpServer::pump(Connection& c) {
+  bool wrote = false;
+  while (c.outHead && c.pcb) {
+    OutSegment* seg = c.outHead;
+    size_t room = tcp_sndbuf(c.pcb);
+    if (room == 0) break;
+    size_t n = seg->length - seg->sent;
+    if (n > room) n = room;
+    const char* src = seg->data + seg->sent;
+    char bounce[HTTP_SERVER_BOUNCE_SIZE];
+    if (seg->capacity == 0) {
+      // lwIP 不能直接读取 flash，先复制到栈上 / lwIP cannot read flash directly, copy to the stack first
+      if (n > sizeof(bounce)) n = sizeof(bounce);
+      memcpy_P(bounce, src, n);
+      src = bounce;
+    }
+    uint8_t flags = TCP_WRITE_FLAG_COPY;
+    if (seg->sent + n < seg->length || seg->next) flags |= TCP_WRITE_FLAG_MORE;
+    if (tcp_write(c.pcb, src, n, flags) != ERR_OK) break;
+    wrote = true;
+    seg->sent += n;
+    if (seg->sent == seg->length) {
+      c.outHead = seg->next;
+      if (!c.outHead) c.outTail = nullptr;
+      free(seg);
+    }
+  }
+  if (wrote) {
+    tcp_output(c.pcb);
+    c.lastProgress = millis();
+  }
+}
+
+void HttpServer::freeOutput(Connection& c) {
+  while (c.outHead) {
+    OutSegment* next = c.outHead->next;
+    free(c.outHead);
+    c.outHead = next;
+  }
+  c.outTail = nullptr;
+}
+
+// =============================
+// 长连接流 / Long-lived streams
+// =============================
+// 流ID = 槽位序号 + 复用计数，旧ID在槽位复用后自动失效 / Stream id = slot index + reuse count, so stale ids die with slot reuse
+int HttpServer::takeStream(PGM_P head) {
+  if (!_current || _current->responseStarted) return -1;
+  Connection& c = *_current;
+  queue(c, head, strlen_P(head), true);
+  pump(c);
+  c.responseStarted = true;
+  c.keepAlive = false;
+  c.state = CONN_STREAM;
+  return (c.generation << 8) | (&c - _conns);
+}
+
+HttpServer::Connection* HttpServer::streamById(int id) const {
+  if (id < 0) return nullptr;
+  size_t index = id & 0xFF;
+  if (index >= HTTP_SERVER_MAX_CONNECTIONS) return nullptr;
+  Connection* c = const_cast<Connection*>(&_conns[index]);
+  if (c->state != CONN_STREAM || c->generation != ((id >> 8) & 0xFF)) return nullptr;
+  return c;
+}
+
+bool HttpServer::streamWrite(int id, const char* data, size_t length) {
+  Connection* c = streamById(id);
+  if (!c || !c->pcb || c->peerClosed) return false;
+  if (c->outHead || tcp_sndbuf(c->pcb) < length) return false; // 不排队，调用方可以丢弃或合并 / Nothing is queued, the caller may drop or coalesce
+  queue(*c, data, length, false);
+  pump(*c);
+  return true;
+}
+
+bool HttpServer::streamConnected(int id) const {
+  Connection* c = streamById(id);
+  return c && c->pcb && !c->peerClosed;
+}
+
+void HttpServer::streamClose(int id) {
+  Connection* c = streamById(id);
+  if (c) closeConnection(*c);
+}
@@ -0,0 +1,280 @@
+// 事件驱动的非阻塞HTTP服务器 / Event-driven non-blocking HTTP server
+//
+// 直接建立在 lwIP 的 TCP 回调之上。回调只把收到的 pbuf 挂到连接上，不做任何解析；loop() 调用 handleClient()
+// 时每个连接按有限的切片推进：增量解析请求头、接收请求体或分段处理上传，然后调用处理函数，响应按发送窗口
+// 分批写出。未读取的数据不向 lwIP 确认，慢速客户端或大文件上传只会被 TCP 流控减速，不会占住主循环。
+// 处理函数接口与 ESP8266WebServer 保持一致（on/arg/send/sendContent/upload ...），已有路由无需修改。
+//
+// Built directly on the lwIP TCP callbacks. The callbacks only queue the received pbufs on the connection and never
+// parse anything; each handleClient() call from loop() advances every connection by a bounded slice: incremental
+// header parsing, body reception or multipart upload slices, then the handler runs and its response is written out
+// as the send window allows. Unread data is not acknowledged to lwIP, so a slow client or a large upload is slowed
+// down by TCP flow control instead of holding the loop. The handler API mirrors ESP8266WebServer
+// (on/arg/send/sendContent/upload ...), so existing routes keep working unchanged.
+//
+// HTTP/1.1 连接默认保持（请求带 Connection: close 或 HTTP/1.0 未带 keep-alive 时除外）。同一连接上的流水线
+// 请求按顺序逐个处理：前一个响应全部交给 lwIP 后才解析下一个请求，响应顺序与请求顺序一致。
+// HTTP/1.1 connections persist by default (unless the request says Connection: close, or is HTTP/1.0 without
+// keep-alive). Pipelined requests on one connection are handled one at a time: the next request is parsed only once the
+// previous response is fully handed to lwIP, so responses come back in request order.
+#pragma once
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h> // 复用 HTTPMethod、HTTPUpload 和 CONTENT_LENGTH_* 定义 / Reuse HTTPMethod, HTTPUpload and CONTENT_LENGTH_*
+#include <functional>
+#include "route_table.h"
+extern "C" {
+#include <lwip/err.h>
+}
+
+struct tcp_pcb;
+struct pbuf;
+
+#ifndef HTTP_SERVER_MAX_CONNECTIONS
+#define HTTP_SERVER_MAX_CONNECTIONS 8 // 同时打开的连接数（含SSE流） / Open connections, SSE streams included
+#endif
+#define HTTP_SERVER_MAX_ROUTES 8 // on() 动态注册的最大路由数，其余在编译期路由表中 / Max routes added with on(); the rest live in the compile-time table
+#define HTTP_SERVER_MAX_HEAD 1024 // 请求行加请求头的最大长度 / Max size of request line plus headers
+#define HTTP_SERVER_MAX_BODY 1024 // 非上传请求体的最大长度 / Max body size of a non-upload request
+#define HTTP_SERVER_MAX_COLLECTED_HEADERS 4 // 可收集的请求头个数 / Number of request headers that can be collected
+#define HTTP_SERVER_SLICE_BYTES 1460 // 每个连接每轮最多处理的输入字节 / Max input bytes per connection per pass
+#define HTTP_SERVER_TIMEOUT_MS 5000 // 请求或响应无进展的超时 / Timeout for a request or response making no progress
+#ifndef HTTP_SERVER_IDLE_TIMEOUT_MS
+#define HTTP_SERVER_IDLE_TIMEOUT_MS 10000 // 长连接两次请求之间的空闲超时 / Idle timeout of a persistent connection between requests
+#endif
+#ifndef HTTP_SERVER_MAX_REQUESTS
+#define HTTP_SERVER_MAX_REQUESTS 100 // 每个长连接最多处理的请求数 / Max requests served on one persistent connection
+#endif
+// 定义 HTTP_SERVER_PROFILE 时按路由统计处理函数耗时和堆内存占用 / With HTTP_SERVER_PROFILE defined, handler time and heap
+// use are recorded per route
+#define HTTP_SERVER_PROFILE_ROUTES 64 // 参与统计的路由数（按路由下标） / Routes profiled (by route index)
+
+class HttpServer {
+public:
+  typedef std::function<void()> THandlerFunction;
+  // 请求头解析完、处理函数运行前调用 / Called once the request head is parsed, before the handler runs
+  typedef std::function<void(HTTPMethod method, const char* uri)> RequestHook;
+  // 准入检查：请求头解析完、读取请求体之前调用，可用 arg()/remoteIP() 查看查询参数和来源；返回 false 时直接回复
+  // 429，不读请求体也不运行处理函数
+  // Admission check: called once the head is parsed, before the body is read; query arguments and the source are
+  // available through arg()/remoteIP(). Returning false answers 429 without reading the body or running the handler
+  typedef std::function<bool(HTTPMethod method, const char* uri)> AdmissionFilter;
+
+  // 连接与请求统计 / Connection and request statistics
+  struct Stats {
+    uint32_t accepted;   // 接受的连接 / Connections accepted
+    uint32_t rejected;   // 槽位已满被拒绝的连接 / Connections rejected with all slots busy
+    uint32_t evicted;    // 为新连接让位而关闭的空闲长连接 / Idle persistent connections closed to make room
+    uint32_t idleClosed; // 空闲超时关闭的长连接 / Persistent connections closed by the idle timeout
+    uint32_t requests;   // 处理的请求 / Requests handled
+    uint32_t reused;     // 在已用过的连接上处理的请求（省去的握手） / Requests on an already used connection (handshakes saved)
+    uint32_t throttled;  // 准入检查拒绝的请求（429） / Requests refused by the admission check (429)
+  };
+
+  // 单个路由的处理函数统计 / Handler statistics of one route
+  struct RouteProfile {
+    uint32_t calls;      // 调用次数 / Calls
+    uint32_t totalUs;    // 累计耗时（微秒） / Total time (microseconds)
+    uint32_t maxUs;      // 最长耗时 / Longest call
+    uint32_t heapPeak;   // 处理期间最多占用的堆（字节） / Most heap in use during a call (bytes)
+    int32_t heapHeld;    // 返回时仍占用的堆最大值，含排队中的响应 / Most heap still held on return, queued response included
+  };
+
+  explicit HttpServer(uint16_t port);
+
+  void begin();
+  void stop();
+  // 每轮 loop() 调用一次，推进所有连接 / Call once per loop() pass; advances every connection
+  void handleClient();
+
+  // 编译期路由表，先于 on() 注册的路由查找 / Compile-time route table, looked up before routes added with on()
+  template <size_t N>
+  void setRoutes(const HttpRouteTable<N>& table) { _table = table.index(); }
+  void on(const char* uri, THandlerFunction handler);
+  void on(const char* uri, HTTPMethod method, THandlerFunction handler);
+  void on(const char* uri, HTTPMethod method, THandlerFunction handler, THandlerFunction uploadHandler);
+  void addHook(RequestHook hook);
+  void setAdmission(AdmissionFilter filter);
+  // 新连接或新数据到达时在 lwIP 回调中置位该标志，用于打断主循环的空闲休眠
+  // Raised from the lwIP callbacks when a connection or data arrives, so the main loop can cut its idle sleep short
+  void setWakeFlag(volatile bool* flag) { _wakeFlag = flag; }
+  void collectHeaders(const char* headerKeys[], size_t count);
+
+  const Stats& stats() const { return _stats; }
+  uint8_t openConnections() const;
+
+  // 路由列表与统计（统计需定义 HTTP_SERVER_PROFILE） / Route list and statistics (statistics need HTTP_SERVER_PROFILE)
+  size_t routeCount() const { return _table.count + _routeCount; }
+  const char* routeUri(size_t route) const;
+#ifdef HTTP_SERVER_PROFILE
+  const RouteProfile& routeProfile(size_t route) const { return _profiles[route]; }
+  void resetProfiles() { memset(_profiles, 0, sizeof(_profiles)); }
+#endif
+
+  // 当前请求，只在处理函数中有效 / Current request, valid inside a handler only
+  HTTPMethod method() const;
+  String uri() const;
+  uint32_t remoteIP() const; // 对端 IPv4 地址，lwIP 字节序 / Peer IPv4 address in lwIP byte order
+  String arg(const String& name) const;
+  bool hasArg(const String& name) const;
+  String header(const String& name) const;
+  bool hasHeader(const String& name) const;
+  HTTPUpload& upload();
+  // 非表单、非上传请求的原始请求体（二进制负载用），没有时返回 nullptr
+  // Raw body of a non-form, non-upload request (for binary payloads); nullptr when there is none
+  const uint8_t* rawBody(size_t& length) const;
+
+  // 响应，写入当前请求的连接 / Response, written to the current request's connection
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void setContentLength(size_t length);
+  void send(int code, const char* contentType = nullptr, const char* content = nullptr);
+  void send(int code, const char* contentType, const String& content);
+  void send(int code, const String& contentType, const String& content);
+  void send(int code, const char* contentType, const uint8_t* content, size_t length);
+  void send_P(int code, PGM_P contentType, PGM_P content);
+  void send_P(int code, PGM_P contentType, PGM_P content, size_t length);
+  void sendContent(const String& content);
+  void sendContent(const char* content, size_t length);
+  void sendContent_P(PGM_P content);
+  void sendContent_P(PGM_P content, size_t length);
+
+  // 长连接流（如SSE）：在处理函数中接管当前连接，写入响应头，返回流ID
+  // Long-lived streams (e.g. SSE): take over the current connection inside a handler, write the head, return a stream id
+  int takeStream(PGM_P head);
+  // 发送缓冲区不足时返回 false 且不写入 / Returns false without writing when the send buffer lacks room
+  bool streamWrite(int id, const char* data, size_t length);
+  bool streamConnected(int id) const;
+  void streamClose(int id);
+
+private:
+  enum ConnState : uint8_t {
+    CONN_FREE,       // 空闲槽位 / Free slot
+    CONN_HEAD,       // 接收请求头 / Receiving the head
+    CONN_BODY,       // 接收请求体 / Receiving the body
+    CONN_UPLOAD,     // 分段处理上传 / Processing a multipart upload
+    CONN_DISCARD,    // 丢弃剩余请求体 / Discarding the rest of the body
+    CONN_RESPONDING, // 等待响应发完 / Waiting for the response to drain
+    CONN_STREAM,     // 长连接流 / Long-lived stream
+  };
+
+  enum MultipartState : uint8_t {
+    MP_DATA,         // 分段数据，直到下一个分隔符 / Part data, up to the next delimiter
+    MP_AFTER_DELIM,  // 分隔符之后的一行 / The line after a delimiter
+    MP_PART_HEADERS, // 分段头 / Part headers
+    MP_EPILOGUE,     // 结束分隔符之后 / After the closing delimiter
+  };
+
+  // 输出段：RAM 数据复制到段内，PROGMEM 数据只保存指针 / Output segment: RAM data is copied in, PROGMEM data is referenced
+  struct OutSegment {
+    OutSegment* next;
+    const char* data;
+    uint16_t length;
+    uint16_t sent;
+    uint16_t capacity; // 0 表示引用 PROGMEM / 0 means a PROGMEM reference
+    char buf[];
+  };
+
+  struct Connection {
+    tcp_pcb* pcb;
+    ConnState state;
+    bool peerClosed; // 对端已关闭或连接出错 / Peer closed or the connection failed
+    bool keepAlive; // 当前请求之后保持连接 / Keep the connection open after the current request
+    uint16_t requests; // 本连接已处理的请求数 / Requests already handled on this connection
+    uint8_t generation; // 槽位复用计数，用于流ID / Slot reuse count, part of stream ids
+    pbuf* rx; // 已收到、尚未处理的数据 / Received data not yet processed
+    uint16_t rxOffset;
+    uint32_t rxUnacked; // 已收到但未向 lwIP 确认的字节 / Bytes received but not yet acknowledged to lwIP
+    char* head; // 请求头缓冲区，上传时复用为行缓冲区 / Head buffer, reused as the line buffer during uploads
+    uint16_t headLen;
+    char* fields; // 打包的 URI、参数和收集的请求头 / Packed URI, arguments and collected headers
+    uint16_t fieldsLen;
+    char* body;
+    uint16_t bodyLen;
+    size_t contentLength;
+    size_t bodyReceived;
+    HTTPMethod method;
+    int16_t route;
+    bool formBody; // 请求体为 application/x-www-form-urlencoded / Body is application/x-www-form-urlencoded
+    bool responseStarted;
+    bool chunked;
+    bool responseComplete; // 响应已完整写入队列 / The whole response is queued
+    OutSegment* outHead;
+    OutSegment* outTail;
+    unsigned long lastProgress;
+    // 上传 / Upload
+    HTTPUpload* upload;
+    char* delimiter; // "\r\n--" + boundary
+    uint8_t delimiterLen;
+    uint8_t delimiterMatched;
+    MultipartState mpState;
+    bool mpFilePart;
+  };
+
+  struct Route {
+    const char* uri;
+    HTTPMethod method;
+    THandlerFunction handler;
+    THandlerFunction uploadHandler;
+  };
+
+  uint16_t _port;
+  tcp_pcb* _listener = nullptr;
+  Connection _conns[HTTP_SERVER_MAX_CONNECTIONS];
+  HttpRouteIndex _table; // 路由下标 0..count-1 / Route indexes 0..count-1
+  Route _routes[HTTP_SERVER_MAX_ROUTES]; // 路由下标从 _table.count 开始 / Route indexes start at _table.count
+  uint8_t _routeCount = 0;
+  RequestHook _hook;
+  AdmissionFilter _admission;
+  static volatile bool* _wakeFlag; // lwIP 回调只拿到连接指针，因此为静态成员 / Static: lwIP callbacks only get the connection
+  const char* _collected[HTTP_SERVER_MAX_COLLECTED_HEADERS];
+  uint8_t _collectedCount = 0;
+  Connection* _current = nullptr; // 正在运行处理函数的连接 / Connection whose handler is running
+  size_t _contentLength = CONTENT_LENGTH_NOT_SET; // 下一次 send() 的长度设置 / Length setting for the next send()
+  String _extraHeaders; // 下一次 send() 附加的响应头 / Extra headers for the next send()
+  Stats _stats = {};
+#ifdef HTTP_SERVER_PROFILE
+  RouteProfile _profiles[HTTP_SERVER_PROFILE_ROUTES] = {};
+#endif
+
+  static err_t onAccept(void* arg, tcp_pcb* pcb, err_t err);
+  static err_t onRecv(void* arg, tcp_pcb* pcb, pbuf* p, err_t err);
+  static void onError(void* arg, err_t err);
+
+  Connection* allocConnection();
+  void closeConnection(Connection& c, bool abort = false);
+  void resetRequest(Connection& c);
+  bool evictIdleConnection();
+  void finishRequest(Connection& c);
+  void advance(Connection& c);
+
+  size_t rxAvailable(const Connection& c) const;
+  size_t rxPeek(const Connection& c, void* dst, size_t length) const;
+  void rxConsume(Connection& c, size_t length);
+
+  bool readHead(Connection& c, size_t& budget);
+  bool parseHead(Connection& c);
+  void startBody(Connection& c);
+  void readBody(Connection& c, size_t& budget);
+  void readUpload(Connection& c, size_t& budget);
+  bool readLine(Connection& c, size_t& budget);
+  void parsePartHeader(Connection& c, const char* line);
+  void emitPartData(Connection& c, const char* data, size_t length);
+  void callUpload(Connection& c, HTTPUploadStatus status);
+  void discardBody(Connection& c, size_t& budget);
+  int findRoute(const char* uri, HTTPMethod method) const;
+  bool hasUploadHandler(int route) const;
+  void callHandler(int route);
+  void dispatch(Connection& c);
+  void sendError(Connection& c, int code);
+
+  void addField(Connection& c, char type, const char* name, size_t nameLen, const char* value, size_t valueLen, bool decode);
+  void parseArgs(Connection& c, const char* query, size_t length);
+  const char* findField(const Connection& c, char type, const char* name) const;
+
+  void writeHead(Connection& c, int code, const char* contentType, bool typeProgmem, size_t length);
+  void queue(Connection& c, const char* data, size_t length, bool progmem);
+  void queueChunk(Connection& c, const char* data, size_t length, bool progmem);
+  void pump(Connection& c);
+  void freeOutput(Connection& c);
+  Connection* streamById(int id) const;
+};
@@ -27,22 +27,30 @@
 
 #include <ESP8266WiFi.h>
 #include <PubSubClient.h>
-#include <ESP8266WebServer.h>
+#include "http_server.h" // 事件驱动的非阻塞HTTP服务器 / Event-driven non-blocking HTTP server
+#include <WebSocketsServer.h> // WebSocket实时控制 / WebSocket real-time control
 #include <WiFiManager.h> // 智能配网库 / Smart configuration library
 #include <ArduinoOTA.h> // OTA升级库 / OTA update library
 #include <EEPROM.h> // 引入EEPROM库，用于保存MQTT地址
 #include <ESP8266HTTPClient.h> // 引入HTTPClient库，用于远程OTA升级
 #include <map> // 引入map库，用于存储控制端信息 / Include map library for storing client info
 #include <BasicStepperDriver.h> // 替换为正确的头文件
+#include "web_assets.h" // 编译前生成的gzip网页资源 / Gzipped web assets generated before the build
+#include <coredecls.h> // crc32()
+#include <lwip/dhcp.h> // DHCP租约信息 / DHCP lease information
+#include <lwip/etharp.h> // 快速连接后的网关ARP检查 / Gateway ARP check after a fast connect
 
 #define EEPROM_SIZE 512 // 定义EEPROM大小
 #define MQTT_ADDRESS_OFFSET 0 // MQTT地址在EEPROM中的起始位置
 #define MQTT_ADDRESS_MAX_LENGTH 100 // MQTT地址的最大长度
 #define MICROSTEP_MODE_EEPROM_ADDR 200 // EEPROM保存细分模式的地址
+#define WIFI_CACHE_EEPROM_ADDR 256 // EEPROM保存WiFi快速连接缓存的地址 / EEPROM address of the WiFi fast-connect cache
+#define WIFI_CACHE_RTC_OFFSET 32 // RTC用户内存块偏移（前128字节被OTA占用） / RTC user memory block offset (first 128 bytes are used by OTA)
 
 char mqtt_server[MQTT_ADDRESS_MAX_LENGTH] = "192.168.1.100"; // 默认MQTT服务器地址
 
-ESP8266WebServer server(80); // 确保 server 的声明在所有函数之前
+HttpServer server(80); // 确保 server 的声明在所有函数之前
+WebSocketsServer webSocket(81); // 实时控制与状态推送 / Real-time control and state push
 WiFiClient espClient; // 确保 espClient 的声明在所有函数之前
 PubSubClient client(espClient); // 确保 client 的声明在所有函数之前
 
@@ -65,6 +73,7 @@ void handleSetMotorRunDuration(); // 处理设置电机启动时长的网页请
 void handleMotorButton(); // 处理电机按钮逻辑 / Handle motor button logic
 void handleMotorRunDuration(); // 处理电机运行时长逻辑 / Handle motor run duration logic
 void handleClientsPage(); // 处理控制端信息页面请求 / Handle client info page request
+void handleClientsList(); // 处理控制端列表请求 / Handle client list request
 void handleSetClientName(); // 处理设置控制端名称的请求 / Handle set client name request
 void updateClientOnlineStatus(String mac); // 更新控制端在线状态 / Update client online status
 void handleResetWiFi(); // 处理重新配网请求 / Handle reset WiFi request
@@ -76,13 +85,522 @@ void handleGetMicrostep(); // 处理获取当前细分模式的请求 / Handle g
 void setMicrostepMode(int microstep); // setMicrostepMode前向声明
 void handleStepOnce(); // 新增单步运行接口，便于调试和外部调用
 void handleApiStepOnce(); // 新增API接口：单步运行（API风格，支持GET/POST）
+void handleMetrics(); // 处理运行指标请求 / Handle runtime metrics request
+void handleBootTiming(); // 处理启动阶段耗时请求 / Handle boot phase timing request
+void handleStalls(); // 处理卡顿记录请求 / Handle stall records request
+void onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length); // 处理WebSocket事件 / Handle WebSocket events
+void pushMotorState(); // 推送电机状态 / Push motor state
+void handleEvents(); // 处理SSE订阅请求 / Handle SSE subscription request
+void pollServerSentEvents(); // 检测状态变化并发送SSE事件 / Detect state changes and send SSE events
+void handleBatch(); // 处理批量控制命令请求 / Handle batch control command request
+#ifdef HTTP_SERVER_PROFILE
+void handleRouteStats(); // 处理路由耗时统计请求 / Handle per-route profiling request
+#endif
+void publishTelemetry(); // 状态变化时发布CBOR遥测 / Publish CBOR telemetry on state changes
+void handleState(); // 处理设备完整状态请求 / Handle full device state request
+void updateStateGeneration(); // 检测设备状态变化并增加代数 / Detect device state changes and bump the generation
+void beginStateEpoch(); // 为本次启动选取ETag纪元 / Pick the ETag epoch of this boot
+bool isCborContainer(const uint8_t* data, size_t length); // 是否为CBOR数组或映射 / Whether the data is a CBOR array or map
+bool cborMapLookup(const uint8_t* data, size_t length, PGM_P key, char* out, size_t size); // 查找CBOR映射中的键 / Look a key up in a CBOR map
+void noteActivity(); // 记录活动，退出空闲模式 / Record activity and leave idle mode
+void idlePollNetwork(); // 空闲休眠切片之间检查网络事件 / Check for network events between idle sleep slices
+
+// =============================
+// 消息目录与语言 / Message catalog and language
+// =============================
+// 日志与网页提示文字统一存放在闪存中，按ID引用；界面语言在编译时通过 -DUI_LANG=... 选择，默认中英双语
+// Log and response texts live in flash and are referenced by id. The language is chosen at build time
+// with -DUI_LANG=...; the default is both Chinese and English.
+#define UI_LANG_ZH 1
+#define UI_LANG_EN 2
+#define UI_LANG_BOTH 3
+#ifndef UI_LANG
+#define UI_LANG UI_LANG_BOTH
+#endif
+
+// 按语言选择无参数文本 / Pick an argument-free text for the selected language
+#if UI_LANG == UI_LANG_ZH
+#define MSG_TEXT(zh, en) zh
+#elif UI_LANG == UI_LANG_EN
+#define MSG_TEXT(zh, en) en
+#else
+#define MSG_TEXT(zh, en) zh " / " en
+#endif
+
+// 网页接口返回的纯文本提示 / Plain-text responses of the web API
+#define TEXT_MESSAGES(X) \
+  X(MSG_MQTT_ADDRESS_UPDATED, "MQTT地址已更新", "MQTT address updated") \
+  X(MSG_ADDRESS_TOO_LONG, "地址过长", "Address too long") \
+  X(MSG_MISSING_ADDRESS, "缺少地址参数", "Missing address parameter") \
+  X(MSG_CONTROLLER_REGISTERED, "控制端已注册", "Controller registered") \
+  X(MSG_SPEED_UP, "电机加速", "Motor speed increased") \
+  X(MSG_SLOW_DOWN, "电机减速", "Motor speed decreased") \
+  X(MSG_MOTOR_ON, "电机已开启", "Motor enabled") \
+  X(MSG_MOTOR_OFF, "电机已关闭", "Motor disabled") \
+  X(MSG_MOTOR_FORWARD, "电机正转", "Motor forward") \
+  X(MSG_MOTOR_REVERSE, "电机反转", "Motor reverse") \
+  X(MSG_UNKNOWN_COMMAND, "未知命令", "Unknown command") \
+  X(MSG_MISSING_COMMAND, "缺少命令参数", "Missing command parameter") \
+  X(MSG_MQTT_CONTROL_ENABLED, "MQTT控制已启用", "MQTT control enabled") \
+  X(MSG_MQTT_CONTROL_DISABLED, "MQTT控制已禁用", "MQTT control disabled") \
+  X(MSG_INVALID_PARAMETER, "无效参数", "Invalid parameter") \
+  X(MSG_MISSING_PARAMETER, "缺少参数", "Missing parameter") \
+  X(MSG_RUN_DURATION_UPDATED, "电机启动时长已更新", "Motor run duration updated") \
+  X(MSG_INVALID_DURATION, "无效的时长，范围为1到1800秒", "Invalid duration, range is 1 to 1800 seconds") \
+  X(MSG_MISSING_DURATION, "缺少时长参数", "Missing duration parameter") \
+  X(MSG_CLIENT_NAME_UPDATED, "控制端名称已更新", "Client name updated") \
+  X(MSG_RESET_WIFI, "设备正在重新进入配网模式，请稍候...", "Device is restarting to enter configuration mode, please wait...") \
+  X(MSG_MICROSTEP_CHANGED, "细分模式已切换", "Microstep mode changed") \
+  X(MSG_INVALID_MICROSTEP, "无效细分模式", "Invalid microstep mode") \
+  X(MSG_STEP_ONCE, "单步运行已执行", "Step motor once executed") \
+  X(MSG_TOO_MANY_SUBSCRIBERS, "事件订阅数已满", "Too many event subscribers") \
+  X(MSG_TOO_MANY_COMMANDS, "批量命令条数过多", "Too many commands in the batch") \
+  X(MSG_TOO_MANY_REQUESTS, "请求过于频繁，请稍后再试", "Too many requests, try again later") \
+  X(MSG_OTA_BEGIN_FAILED, "OTA初始化失败", "OTA initialization failed") \
+  X(MSG_OTA_WRITE_FAILED, "OTA写入失败", "OTA write failed") \
+  X(MSG_OTA_SUCCESS, "OTA更新成功，设备将在5秒后重启", "OTA update successful, device will restart in 5 seconds") \
+  X(MSG_OTA_FAILED, "OTA更新失败", "OTA update failed") \
+  X(MSG_OTA_REMOTE_SUCCESS, "远程OTA更新成功，设备即将重启", "Remote OTA update successful, device will restart") \
+  X(MSG_OTA_REMOTE_FAILED, "远程OTA更新失败", "Remote OTA update failed") \
+  X(MSG_OTA_BAD_SIZE, "远程固件大小无效", "Invalid firmware size") \
+  X(MSG_OTA_HTTP_FAILED, "HTTP请求失败", "HTTP request failed") \
+  X(MSG_OTA_UNREACHABLE, "无法连接到远程地址", "Unable to connect to remote URL") \
+  X(MSG_OTA_MISSING_URL, "缺少远程地址参数", "Missing remote URL parameter")
+
+#define TEXT_ENUM_ENTRY(id, zh, en) id,
+#define TEXT_DEFINE(id, zh, en) static const char id##_TEXT[] PROGMEM = MSG_TEXT(zh, en);
+#define TEXT_ENTRY(id, zh, en) id##_TEXT,
+
+enum TextMessageId : uint8_t {
+  TEXT_MESSAGES(TEXT_ENUM_ENTRY)
+  TEXT_MESSAGE_COUNT
+};
+
+TEXT_MESSAGES(TEXT_DEFINE)
+const char* const TEXT_MESSAGE_TEXTS[TEXT_MESSAGE_COUNT] PROGMEM = {
+  TEXT_MESSAGES(TEXT_ENTRY)
+};
+
+// 响应和负载的编码格式 / Encoding of responses and payloads
+enum PayloadFormat : uint8_t {
+  FORMAT_JSON,
+  FORMAT_CBOR,
+};
+
+PayloadFormat requestedFormat();
+void sendCborTextMessage(int code, PGM_P text);
+
+// 直接从闪存发送纯文本提示；请求CBOR时包装为CBOR对象 / Send a plain-text response straight from flash; wrapped in a
+// CBOR object when the request asks for CBOR
+void sendTextMessage(int code, TextMessageId id) {
+  PGM_P text = (PGM_P)pgm_read_ptr(&TEXT_MESSAGE_TEXTS[id]);
+  if (requestedFormat() == FORMAT_CBOR) {
+    sendCborTextMessage(code, text);
+    return;
+  }
+  server.send_P(code, PSTR("text/plain; charset=utf-8"), text);
+}
+
+// =============================
+// 延迟日志 / Deferred logging
+// =============================
+// 日志调用只把紧凑记录（时间戳、消息ID、参数）写入RAM环形缓冲区，不做格式化也不碰串口；
+// loop() 空闲时再格式化，并按UART FIFO剩余空间非阻塞输出，电机路径永远不会被串口阻塞。
+// Log calls only push a compact record (timestamp, message id, args) into a RAM ring. Formatting and
+// output happen from idle time in loop(), limited to the free UART FIFO space, so stepping never blocks on Serial.
+
+// 日志级别；LOG_LEVEL 可在 platformio.ini 中通过 -DLOG_LEVEL=... 设置，默认输出全部日志
+// Log levels; LOG_LEVEL can be set with -DLOG_LEVEL=... in platformio.ini and defaults to everything
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// 低于 LOG_LEVEL 的消息格式替换为空串，不占闪存 / Formats below LOG_LEVEL are replaced by "" so they take no flash
+#define LOG_TEXT_ERROR(fmt) fmt
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_TEXT_WARN(fmt) fmt
+#else
+#define LOG_TEXT_WARN(fmt) ""
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_TEXT_INFO(fmt) fmt
+#else
+#define LOG_TEXT_INFO(fmt) ""
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_TEXT_DEBUG(fmt) fmt
+#else
+#define LOG_TEXT_DEBUG(fmt) ""
+#endif
+
+// 日志消息目录：ID、级别与中英文格式字符串（存放在闪存中），每种语言的格式按相同顺序使用参数
+// Log message catalog: id, level and Chinese/English formats (kept in flash); both formats take the arguments in the same order
+#define LOG_MESSAGES(X) \
+  X(LOG_BOOT_BANNER, INFO, "ESP8266 步进电机远程控制系统", "ESP8266 Stepper Motor Remote Control System") \
+  X(LOG_FIRMWARE_VERSION, INFO, "固件版本: %s", "Firmware Version: %s") \
+  X(LOG_BUTTONS_READY, INFO, "物理按钮初始化完成", "Physical buttons initialized") \
+  X(LOG_STEPPER_READY, INFO, "请确保A4988的MS1/MS2/MS3与细分模式一致，脉冲/圈=%d", "Make sure A4988 MS1/MS2/MS3 match the microstep mode, pulses/rev=%d") \
+  X(LOG_WEB_STARTED, INFO, "Web服务器已启动", "Web server started") \
+  X(LOG_MQTT_ADDRESS_LOADED, INFO, "加载的MQTT地址: %s", "Loaded MQTT address: %s") \
+  X(LOG_MQTT_ADDRESS_SAVED, DEBUG, "保存的MQTT地址: %s", "Saved MQTT address: %s") \
+  X(LOG_MQTT_ADDRESS_UPDATED, INFO, "MQTT地址已更新为: %s", "MQTT address updated to: %s") \
+  X(LOG_MQTT_ADDRESS_TOO_LONG, WARN, "设置MQTT地址失败：地址过长", "Failed to set MQTT address: Address too long") \
+  X(LOG_MQTT_ADDRESS_MISSING, WARN, "设置MQTT地址失败：缺少地址参数", "Failed to set MQTT address: Missing address parameter") \
+  X(LOG_CONTROLLER_REGISTERED, INFO, "控制端已注册，MAC地址: %s", "Controller registered, MAC address: %s") \
+  X(LOG_MQTT_RECONNECT_DISABLED, DEBUG, "MQTT控制已禁用，跳过重连", "MQTT control disabled, skipping reconnect") \
+  X(LOG_MQTT_CONTROLLER_OFFLINE, DEBUG, "控制端未上线，跳过MQTT连接", "Controller not online, skipping MQTT connection") \
+  X(LOG_MQTT_CONNECTING, DEBUG, "尝试连接MQTT服务器: %s", "Attempting to connect to MQTT server: %s") \
+  X(LOG_MQTT_CONNECTED, INFO, "MQTT连接成功", "MQTT connected") \
+  X(LOG_MQTT_CONNECT_FAILED, WARN, "MQTT连接失败，state=%d", "MQTT connection failed, state=%d") \
+  X(LOG_MQTT_CHECKS_DISABLED, DEBUG, "MQTT控制已禁用，跳过MQTT检测", "MQTT control disabled, skipping MQTT checks") \
+  X(LOG_MQTT_MESSAGE_IGNORED, DEBUG, "MQTT控制已禁用，忽略消息", "MQTT control disabled, ignoring message") \
+  X(LOG_MQTT_MESSAGE, DEBUG, "收到 MQTT 消息，主题: %s，内容: %s", "MQTT message received, topic: %s, payload: %s") \
+  X(LOG_MQTT_FORWARD, INFO, "电机正向运动（通过 MQTT）", "Motor moving forward (via MQTT)") \
+  X(LOG_MQTT_REVERSE, INFO, "电机反向运动（通过 MQTT）", "Motor moving reverse (via MQTT)") \
+  X(LOG_MQTT_STOP, INFO, "电机停止（通过 MQTT）", "Motor stopped (via MQTT)") \
+  X(LOG_MQTT_STEP_ONCE, INFO, "收到MQTT单步运行指令", "Step motor once by MQTT") \
+  X(LOG_MQTT_UNHANDLED_TOPIC, WARN, "未处理的 MQTT 主题: %s", "Unhandled MQTT topic: %s") \
+  X(LOG_MQTT_MOTOR_COMMAND, DEBUG, "处理MQTT电机控制消息: %s", "Handling MQTT motor control message: %s") \
+  X(LOG_MOTOR_ON_MQTT, INFO, "电机已开启（通过MQTT）", "Motor enabled (via MQTT)") \
+  X(LOG_MOTOR_OFF_MQTT, INFO, "电机已关闭（通过MQTT）", "Motor disabled (via MQTT)") \
+  X(LOG_MOTOR_FORWARD_MQTT, INFO, "电机正转（通过MQTT）", "Motor forward (via MQTT)") \
+  X(LOG_MOTOR_REVERSE_MQTT, INFO, "电机反转（通过MQTT）", "Motor reverse (via MQTT)") \
+  X(LOG_MQTT_UNKNOWN_COMMAND, WARN, "未知的电机控制命令（通过MQTT）: %s", "Unknown motor control command (via MQTT): %s") \
+  X(LOG_MQTT_CONTROL_ENABLED, INFO, "MQTT控制已启用", "MQTT control enabled") \
+  X(LOG_MQTT_CONTROL_DISABLED, INFO, "MQTT控制已禁用", "MQTT control disabled") \
+  X(LOG_MQTT_CONTROL_INVALID, WARN, "无效的MQTT控制参数", "Invalid MQTT control parameter") \
+  X(LOG_MQTT_CONTROL_MISSING, WARN, "缺少MQTT控制参数", "Missing MQTT control parameter") \
+  X(LOG_MOTOR_ACTIVITY, DEBUG, "电机活动时间已更新", "Motor activity timestamp updated") \
+  X(LOG_MOTOR_INACTIVITY_OFF, INFO, "电机因未使用超时已禁用", "Motor disabled due to inactivity timeout") \
+  X(LOG_MOTOR_STARTED, INFO, "电机启动", "Motor started") \
+  X(LOG_MOTOR_ON_BUTTON, INFO, "电机已开启（通过按钮）", "Motor enabled (via button)") \
+  X(LOG_MOTOR_OFF_BUTTON, INFO, "电机已关闭（通过按钮）", "Motor disabled (via button)") \
+  X(LOG_DIRECTION_FORWARD_BUTTON, INFO, "电机方向已切换为正转（通过按钮）", "Motor direction toggled to forward (via button)") \
+  X(LOG_DIRECTION_REVERSE_BUTTON, INFO, "电机方向已切换为反转（通过按钮）", "Motor direction toggled to reverse (via button)") \
+  X(LOG_LIMIT_FORWARD, INFO, "限位触发，电机方向已切换为正转", "Limit triggered, motor direction toggled to forward") \
+  X(LOG_LIMIT_REVERSE, INFO, "限位触发，电机方向已切换为反转", "Limit triggered, motor direction toggled to reverse") \
+  X(LOG_RUN_DURATION_ELAPSED, INFO, "电机运行时间到，已停止", "Motor run duration elapsed, stopped") \
+  X(LOG_MOTOR_ON_WEB, INFO, "电机已开启（通过网页）", "Motor enabled (via web)") \
+  X(LOG_MOTOR_OFF_WEB, INFO, "电机已关闭（通过网页）", "Motor disabled (via web)") \
+  X(LOG_DIRECTION_FORWARD_WEB, INFO, "电机方向已切换为正转（通过网页）", "Motor direction toggled to forward (via web)") \
+  X(LOG_DIRECTION_REVERSE_WEB, INFO, "电机方向已切换为反转（通过网页）", "Motor direction toggled to reverse (via web)") \
+  X(LOG_API_COMMAND, DEBUG, "收到API请求，命令: %s", "Received API request, command: %s") \
+  X(LOG_MOTOR_ON_API, INFO, "电机已开启（通过API）", "Motor enabled (via API)") \
+  X(LOG_MOTOR_OFF_API, INFO, "电机已关闭（通过API）", "Motor disabled (via API)") \
+  X(LOG_MOTOR_FORWARD_API, INFO, "电机正转（通过API）", "Motor forward (via API)") \
+  X(LOG_MOTOR_REVERSE_API, INFO, "电机反转（通过API）", "Motor reverse (via API)") \
+  X(LOG_API_UNKNOWN_COMMAND, WARN, "收到未知命令（通过API）", "Unknown command received (via API)") \
+  X(LOG_API_MISSING_COMMAND, WARN, "API请求缺少命令参数", "API request missing command parameter") \
+  X(LOG_MICROSTEP_CHANGED, INFO, "已切换细分模式: %d, 每圈脉冲数: %d, 最小脉冲间隔: %u us", "Microstep mode: %d, pulses/rev: %d, min step interval: %u us") \
+  X(LOG_SPEED_CHANGED, INFO, "当前脉冲间隔: %u us, 约 %u.%02u 转/秒", "Step interval: %u us, about %u.%02u rev/s") \
+  X(LOG_RUN_DURATION_SET, INFO, "电机启动时长设置为: %d 秒", "Motor run duration set to: %d s") \
+  X(LOG_RUN_DURATION_INVALID, WARN, "设置电机启动时长失败：无效的时长", "Failed to set motor run duration: Invalid duration") \
+  X(LOG_RUN_DURATION_MISSING, WARN, "设置电机启动时长失败：缺少时长参数", "Failed to set motor run duration: Missing duration parameter") \
+  X(LOG_CLIENT_NAME_UPDATED, INFO, "控制端名称已更新: MAC=%s, 名称=%s", "Client name updated: MAC=%s, name=%s") \
+  X(LOG_CLIENT_ONLINE, DEBUG, "控制端在线: MAC=%s", "Client online: MAC=%s") \
+  X(LOG_WIFI_CACHE_UPDATED, DEBUG, "WiFi快速连接缓存已更新", "WiFi fast-connect cache updated") \
+  X(LOG_WIFI_PORTAL, INFO, "进入智能配网模式", "Entering smart configuration mode") \
+  X(LOG_WIFI_FAST_CONNECT, INFO, "使用缓存快速连接WiFi: %s, 信道 %d", "Fast connecting to WiFi: %s, channel %d") \
+  X(LOG_WIFI_CONNECTING, INFO, "正在连接WiFi: %s", "Connecting to WiFi: %s") \
+  X(LOG_WIFI_CONNECTED, INFO, "WiFi连接成功, IP %s, 耗时 %lu ms", "WiFi connected, IP %s, %lu ms") \
+  X(LOG_WIFI_FAST_FAILED, WARN, "快速连接失败，回退到完整扫描", "Fast connect failed, falling back to full scan") \
+  X(LOG_WIFI_LEASE_UNKNOWN, INFO, "缓存的IP租约已过半或未知，使用DHCP", "Cached IP lease is past half or unknown, using DHCP") \
+  X(LOG_WIFI_LINK_CHECK_FAILED, WARN, "网关无ARP应答，放弃缓存的IP", "No ARP reply from the gateway, dropping the cached IP") \
+  X(LOG_WIFI_LEASE_RENEW, INFO, "缓存的IP租约已过半，切换到DHCP", "Cached IP lease is past half, switching to DHCP") \
+  X(LOG_WIFI_CONNECT_FAILED, WARN, "WiFi连接失败，第 %d 次", "WiFi connection failed, attempt %d") \
+  X(LOG_WIFI_TOO_MANY_FAILURES, WARN, "WiFi连接失败超过3次，进入智能配网模式", "WiFi connection failed more than 3 times, entering smart configuration mode") \
+  X(LOG_WIFI_LOST, WARN, "WiFi连接已断开，等待重连", "WiFi connection lost, waiting for reconnect") \
+  X(LOG_RESET_WIFI_REQUEST, INFO, "收到重新配网请求，准备进入智能配网模式", "Received reset WiFi request, preparing to enter smart configuration mode") \
+  X(LOG_RESET_WIFI_RESTART, INFO, "WiFi已断开，设备即将重启", "WiFi disconnected, device will restart") \
+  X(LOG_OTA_STARTED, INFO, "OTA功能已启动", "OTA functionality started") \
+  X(LOG_OTA_START, INFO, "开始OTA更新: %s", "Starting OTA update: %s") \
+  X(LOG_OTA_END, INFO, "OTA更新完成", "OTA update completed") \
+  X(LOG_OTA_PROGRESS, DEBUG, "OTA更新进度: %u%%", "OTA update progress: %u%%") \
+  X(LOG_OTA_ERROR_AUTH, ERROR, "OTA更新错误：认证失败", "OTA update error: Authentication failed") \
+  X(LOG_OTA_ERROR_BEGIN, ERROR, "OTA更新错误：开始失败", "OTA update error: Begin failed") \
+  X(LOG_OTA_ERROR_CONNECT, ERROR, "OTA更新错误：连接失败", "OTA update error: Connection failed") \
+  X(LOG_OTA_ERROR_RECEIVE, ERROR, "OTA更新错误：接收失败", "OTA update error: Receive failed") \
+  X(LOG_OTA_ERROR_END, ERROR, "OTA更新错误：结束失败", "OTA update error: End failed") \
+  X(LOG_OTA_ERROR, ERROR, "OTA更新错误 [%u]", "OTA update error [%u]") \
+  X(LOG_OTA_UPLOAD_START, INFO, "开始上传固件: %s", "Firmware upload started: %s") \
+  X(LOG_OTA_BEGIN_FAILED, ERROR, "OTA初始化失败，错误代码: %d", "OTA initialization failed, error code: %d") \
+  X(LOG_OTA_WRITE_FAILED, ERROR, "OTA写入失败，错误代码: %d", "OTA write failed, error code: %d") \
+  X(LOG_OTA_SUCCESS, INFO, "OTA更新成功", "OTA update successful") \
+  X(LOG_OTA_FAILED, ERROR, "OTA更新失败，错误代码: %d", "OTA update failed, error code: %d") \
+  X(LOG_OTA_REMOTE_START, INFO, "开始远程OTA升级，地址: %s", "Remote OTA update started, URL: %s") \
+  X(LOG_OTA_REMOTE_SUCCESS, INFO, "远程OTA更新成功", "Remote OTA update successful") \
+  X(LOG_OTA_REMOTE_FAILED, ERROR, "远程OTA更新失败，错误代码: %d", "Remote OTA update failed, error code: %d") \
+  X(LOG_OTA_REMOTE_BAD_SIZE, ERROR, "远程固件大小无效", "Invalid firmware size") \
+  X(LOG_OTA_REMOTE_HTTP_FAILED, ERROR, "HTTP请求失败，状态码: %d", "HTTP request failed, status code: %d") \
+  X(LOG_OTA_REMOTE_UNREACHABLE, ERROR, "无法连接到远程地址", "Unable to connect to remote URL") \
+  X(LOG_WS_CONNECTED, INFO, "WebSocket客户端 #%u 已连接", "WebSocket client #%u connected") \
+  X(LOG_WS_DISCONNECTED, INFO, "WebSocket客户端 #%u 已断开", "WebSocket client #%u disconnected") \
+  X(LOG_WS_COMMAND, DEBUG, "收到WebSocket命令: %s", "WebSocket command: %s") \
+  X(LOG_WS_UNKNOWN_COMMAND, WARN, "未知的WebSocket命令", "Unknown WebSocket command") \
+  X(LOG_MOTOR_ON_CMD, INFO, "电机已开启（通过控制命令）", "Motor enabled (via control command)") \
+  X(LOG_MOTOR_OFF_CMD, INFO, "电机已关闭（通过控制命令）", "Motor disabled (via control command)") \
+  X(LOG_DIRECTION_FORWARD_CMD, INFO, "电机方向已切换为正转（通过控制命令）", "Motor direction set to forward (via control command)") \
+  X(LOG_DIRECTION_REVERSE_CMD, INFO, "电机方向已切换为反转（通过控制命令）", "Motor direction set to reverse (via control command)") \
+  X(LOG_MOTOR_RUN_CMD, INFO, "电机定长运行 %lu 步", "Motor running %lu steps") \
+  X(LOG_MOTOR_RUN_DONE, INFO, "定长运行完成，电机已停止", "Counted run finished, motor stopped") \
+  X(LOG_BATCH_APPLIED, INFO, "批量命令已执行，共 %d 条", "Batch applied, %d commands") \
+  X(LOG_BATCH_REJECTED, WARN, "批量命令校验失败，第 %d 条无效，全部未执行", "Batch rejected, command %d is invalid, nothing applied") \
+  X(LOG_SSE_SUBSCRIBED, INFO, "SSE订阅已建立，槽位 %d", "SSE subscriber added, slot %d") \
+  X(LOG_SSE_REJECTED, WARN, "SSE订阅数已满，拒绝新订阅", "SSE subscribers full, rejecting") \
+  X(LOG_SSE_CLOSED, INFO, "SSE订阅已断开，槽位 %d", "SSE subscriber closed, slot %d") \
+  X(LOG_STALL_DETECTED, WARN, "主循环卡顿，子系统: %s，持续 %lu ms", "Loop stall in %s, %lu ms") \
+  X(LOG_STALL_RESET, WARN, "上次运行在卡顿中复位，子系统: %s，已持续 %lu ms", "Previous run reset during a stall in %s after %lu ms") \
+  X(LOG_RECORDS_DROPPED, WARN, "日志缓冲区已满，丢弃记录数: %lu", "Log buffer full, records dropped: %lu")
+
+#define LOG_ENUM_ENTRY(id, level, zh, en) id,
+#define LOG_LEVEL_ENTRY(id, level, zh, en) LOG_LEVEL_##level,
+#define LOG_FORMAT_DEFINE_ZH(id, level, zh, en) static const char id##_ZH[] PROGMEM = LOG_TEXT_##level(zh);
+#define LOG_FORMAT_DEFINE_EN(id, level, zh, en) static const char id##_EN[] PROGMEM = LOG_TEXT_##level(en);
+#define LOG_FORMAT_ENTRY_ZH(id, level, zh, en) id##_ZH,
+#define LOG_FORMAT_ENTRY_EN(id, level, zh, en) id##_EN,
+
+enum LogMessageId : uint16_t {
+  LOG_MESSAGES(LOG_ENUM_ENTRY)
+  LOG_MESSAGE_COUNT
+};
+
+constexpr uint8_t LOG_MESSAGE_LEVELS[LOG_MESSAGE_COUNT] = {
+  LOG_MESSAGES(LOG_LEVEL_ENTRY)
+};
+
+// 只编译所选语言的格式 / Only the formats of the selected language are compiled in
+#if UI_LANG != UI_LANG_EN
+LOG_MESSAGES(LOG_FORMAT_DEFINE_ZH)
+const char* const LOG_FORMATS_ZH[LOG_MESSAGE_COUNT] PROGMEM = {
+  LOG_MESSAGES(LOG_FORMAT_ENTRY_ZH)
+};
+#endif
+#if UI_LANG != UI_LANG_ZH
+LOG_MESSAGES(LOG_FORMAT_DEFINE_EN)
+const char* const LOG_FORMATS_EN[LOG_MESSAGE_COUNT] PROGMEM = {
+  LOG_MESSAGES(LOG_FORMAT_ENTRY_EN)
+};
+#endif
+
+#define LOG_ARG_MAX 3 // 每条记录最多参数数 / Max arguments per record
+#define LOG_STR_MAX 32 // 记录内字符串参数的总空间 / Inline storage for string arguments
+#define LOG_RING_SIZE 32 // 环形缓冲区记录数 / Records in the ring buffer
+
+// 紧凑日志记录（52字节），字符串参数以'\0'分隔依次存放在 str 中
+// Compact log record (52 bytes); string arguments are stored back to back in str, '\0' separated
+struct LogRecord {
+  uint32_t timestamp; // millis()
+  uint8_t id; // LogMessageId
+  uint8_t argc; // 参数个数 / Argument count
+  uint8_t strMask; // 哪些参数是字符串（按位） / Which arguments are strings (bitmask)
+  uint8_t strLen; // str 已用长度 / Bytes of str in use
+  uint32_t args[LOG_ARG_MAX];
+  char str[LOG_STR_MAX];
+};
+static_assert(LOG_MESSAGE_COUNT <= 256, "log message id must fit in uint8_t");
+
+LogRecord logRing[LOG_RING_SIZE];
+uint8_t logHead = 0; // 下一条写入位置 / Next write slot
+uint8_t logTail = 0; // 下一条输出位置 / Next slot to drain
+uint8_t logCount = 0; // 排队记录数 / Queued records
+unsigned long logDropped = 0; // 累计丢弃数 / Total dropped records
+unsigned long logDroppedReported = 0; // 已报告的丢弃数 / Drops already reported
+unsigned long logWritten = 0; // 已输出记录数 / Records written to Serial
+
+char logLine[192]; // 正在输出的一行 / Line currently being written
+uint16_t logLineLen = 0;
+uint16_t logLinePos = 0;
+
+// 把参数打包进记录 / Pack arguments into a record
+inline void logPackArg(LogRecord& rec, const char* value) {
+  if (!value) value = "";
+  size_t room = LOG_STR_MAX - rec.strLen;
+  if (room > 0) {
+    strlcpy(rec.str + rec.strLen, value, room);
+    rec.strLen += strlen(rec.str + rec.strLen) + 1;
+  }
+  rec.strMask |= 1 << rec.argc;
+  rec.args[rec.argc++] = 0; // 输出时替换为 str 中的地址 / Replaced by an address inside str when drained
+}
+
+inline void logPackArg(LogRecord& rec, char* value) {
+  logPackArg(rec, (const char*)value);
+}
+
+inline void logPackArg(LogRecord& rec, const String& value) {
+  logPackArg(rec, value.c_str());
+}
+
+template <typename T>
+inline void logPackArg(LogRecord& rec, T value) {
+  rec.args[rec.argc++] = (uint32_t)value;
+}
+
+// 写入一条日志记录；缓冲区满时丢弃并计数 / Queue one log record; drop and count when the ring is full
+template <typename... Args>
+void logWrite(LogMessageId id, const Args&... args) {
+  static_assert(sizeof...(Args) <= LOG_ARG_MAX, "too many log arguments");
+  if (logCount >= LOG_RING_SIZE) {
+    logDropped++;
+    return;
+  }
+  LogRecord& rec = logRing[logHead];
+  rec.timestamp = millis();
+  rec.id = id;
+  rec.argc = 0;
+  rec.strMask = 0;
+  rec.strLen = 0;
+  int expand[] = {0, (logPackArg(rec, args), 0)...};
+  (void)expand;
+  logHead = (logHead + 1) % LOG_RING_SIZE;
+  logCount++;
+}
+
+// 分级日志宏：调用处的级别须与目录一致；被关闭的级别展开为空语句，参数不会被求值
+// Leveled log macros: the call-site level must match the catalog. Disabled levels expand to an empty
+// statement, so their arguments are never evaluated or compiled in.
+#define LOG_AT(level, id, ...) do { \
+    static_assert(LOG_MESSAGE_LEVELS[id] == level, #id " is logged at the wrong level"); \
+    logWrite(id, ##__VA_ARGS__); \
+  } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(id, ...) LOG_AT(LOG_LEVEL_ERROR, id, ##__VA_ARGS__)
+#else
+#define LOG_E(id, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(id, ...) LOG_AT(LOG_LEVEL_WARN, id, ##__VA_ARGS__)
+#else
+#define LOG_W(id, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(id, ...) LOG_AT(LOG_LEVEL_INFO, id, ##__VA_ARGS__)
+#else
+#define LOG_I(id, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(id, ...) LOG_AT(LOG_LEVEL_DEBUG, id, ##__VA_ARGS__)
+#else
+#define LOG_D(id, ...) do {} while (0)
+#endif
+
+// 在 logLine 末尾追加格式化文本，超长时截断并为行尾留出空间 / Append formatted text to logLine, truncating and keeping room for the line ending
+int logAppend(int len, PGM_P format, uintptr_t a0, uintptr_t a1, uintptr_t a2) {
+  int room = sizeof(logLine) - 2 - len;
+  if (room <= 1) return len;
+  int n = snprintf_P(logLine + len, room, format, a0, a1, a2);
+  if (n < 0) return len;
+  return n < room ? len + n : len + room - 1;
+}
+
+// 把一条记录格式化到 logLine / Format one record into logLine
+void logFormat(const LogRecord& rec) {
+  uintptr_t args[LOG_ARG_MAX] = {0}; // 与指针同宽，字符串参数可直接作为%s传递 / Pointer-wide so string args pass as %s
+  const char* str = rec.str;
+  const char* strEnd = rec.str + rec.strLen;
+  for (uint8_t i = 0; i < rec.argc; i++) {
+    if (rec.strMask & (1 << i)) {
+      const char* value = str < strEnd ? str : "";
+      if (str < strEnd) str += strlen(str) + 1;
+      args[i] = (uintptr_t)value;
+    } else {
+      args[i] = rec.args[i];
+    }
+  }
+  int len = logAppend(0, PSTR("[%lu] "), (uintptr_t)rec.timestamp, 0, 0);
+#if UI_LANG != UI_LANG_EN
+  len = logAppend(len, (PGM_P)pgm_read_ptr(&LOG_FORMATS_ZH[rec.id]), args[0], args[1], args[2]);
+#endif
+#if UI_LANG == UI_LANG_BOTH
+  len = logAppend(len, PSTR(" / "), 0, 0, 0);
+#endif
+#if UI_LANG != UI_LANG_ZH
+  len = logAppend(len, (PGM_P)pgm_read_ptr(&LOG_FORMATS_EN[rec.id]), args[0], args[1], args[2]);
+#endif
+  logLine[len++] = '\r';
+  logLine[len++] = '\n';
+  logLineLen = len;
+  logLinePos = 0;
+}
+
+// 空闲时输出日志：只写入UART FIFO剩余空间，从不阻塞 / Drain logs from idle time: only fill free UART FIFO space, never block
+void logDrain() {
+  while (true) {
+    if (logLinePos >= logLineLen) {
+      if (LOG_LEVEL >= LOG_LEVEL_WARN && logDropped != logDroppedReported) {
+        // 丢弃报告本身不占缓冲区 / The drop report does not take a ring slot
+        LogRecord rec = {};
+        rec.timestamp = millis();
+        rec.id = LOG_RECORDS_DROPPED;
+        rec.argc = 1;
+        rec.args[0] = logDropped - logDroppedReported;
+        logDroppedReported = logDropped;
+        logFormat(rec);
+      } else if (logCount > 0) {
+        logFormat(logRing[logTail]);
+        logTail = (logTail + 1) % LOG_RING_SIZE;
+        logCount--;
+        logWritten++;
+      } else {
+        return;
+      }
+    }
+    int room = Serial.availableForWrite();
+    if (room <= 0) return;
+    size_t chunk = min((size_t)room, (size_t)(logLineLen - logLinePos));
+    Serial.write((const uint8_t*)logLine + logLinePos, chunk);
+    logLinePos += chunk;
+    if (logLinePos < logLineLen) return; // FIFO已满，下次继续 / FIFO full, continue next time
+  }
+}
+
+// 阻塞式输出全部日志，仅用于重启前 / Blocking drain of all logs, only used right before a restart
+void logFlush() {
+  while (logCount > 0 || logLinePos < logLineLen || (LOG_LEVEL >= LOG_LEVEL_WARN && logDropped != logDroppedReported)) {
+    logDrain();
+    yield();
+  }
+  Serial.flush();
+}
 
 // WiFi连接失败计数器 / WiFi connection failure counter
 int wifiConnectFailures = 0;
 
+// 启动阶段定义（按依赖顺序） / Boot phases, in dependency order
+enum BootPhase {
+  BOOT_PHASE_PINS,       // 引脚初始化完成 / Pins initialized
+  BOOT_PHASE_EEPROM,     // EEPROM配置加载完成 / EEPROM settings loaded
+  BOOT_PHASE_STEPPER,    // 步进驱动配置完成 / Stepper driver configured
+  BOOT_PHASE_WEB,        // Web服务器启动 / Web server started
+  BOOT_PHASE_WIFI,       // WiFi已连接 / WiFi connected
+  BOOT_PHASE_MQTT,       // MQTT首次连接 / First MQTT connection
+  BOOT_PHASE_OTA,        // OTA已启动 / OTA started
+  BOOT_PHASE_FIRST_STEP, // 第一个步进脉冲 / First step pulse
+  BOOT_PHASE_COUNT
+};
+
+const char* const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {
+  "pins", "eeprom", "stepper", "web", "wifi", "mqtt", "ota", "firstStep"
+};
+
+// 各阶段完成时间（上电后的微秒数，0表示尚未完成） / Completion time of each phase (microseconds since boot, 0 = not reached)
+uint64_t bootPhaseTimes[BOOT_PHASE_COUNT] = {0};
+
+// 记录启动阶段完成时间，只记录第一次 / Record the completion time of a boot phase, first occurrence only
+void markBootPhase(BootPhase phase) {
+  if (bootPhaseTimes[phase] == 0) {
+    bootPhaseTimes[phase] = micros64();
+  }
+}
+
 // 加载保存的MQTT地址 / Load the saved MQTT address from EEPROM
 void loadMQTTAddress() {
-  EEPROM.begin(EEPROM_SIZE); // 初始化EEPROM / Initialize EEPROM
   for (int i = 0; i < MQTT_ADDRESS_MAX_LENGTH; i++) {
     mqtt_server[i] = EEPROM.read(MQTT_ADDRESS_OFFSET + i); // 从EEPROM读取字符 / Read characters from EEPROM
     if (mqtt_server[i] == '\0') break; // 遇到字符串结束符停止读取 / Stop reading at null terminator
@@ -90,7 +608,7 @@ void loadMQTTAddress() {
   if (mqtt_server[0] == '\0') {
     strcpy(mqtt_server, "192.168.1.100"); // 如果未设置地址，使用默认值 / Use default if no address is set
   }
-  Serial.println("加载的MQTT地址: " + String(mqtt_server)); // 打印加载的地址 / Print the loaded address
+  LOG_I(LOG_MQTT_ADDRESS_LOADED, mqtt_server); // 打印加载的地址 / Print the loaded address
 }
 
 // 保存MQTT地址到EEPROM / Save the MQTT address to EEPROM
@@ -100,7 +618,7 @@ void saveMQTTAddress(const char* address) {
     if (address[i] == '\0') break; // 遇到字符串结束符停止写入 / Stop writing at null terminator
   }
   EEPROM.commit(); // 提交更改 / Commit changes
-  Serial.println("保存的MQTT地址: " + String(address)); // 打印保存的地址 / Print the saved address
+  LOG_D(LOG_MQTT_ADDRESS_SAVED, address); // 打印保存的地址 / Print the saved address
 }
 
 // 处理设置MQTT地址的网页请求 / Handle web request to set MQTT address
@@ -111,15 +629,15 @@ void handleSetMQTTAddress() {
       address.toCharArray(mqtt_server, MQTT_ADDRESS_MAX_LENGTH); // 将地址转换为字符数组 / Convert address to char array
       saveMQTTAddress(mqtt_server); // 保存地址到EEPROM / Save address to EEPROM
       client.setServer(mqtt_server, 1883); // 更新MQTT服务器地址 / Update MQTT server address
-      Serial.printf("MQTT地址已更新为: %s / MQTT address updated to: %s\n", mqtt_server, mqtt_server);
-      server.send(200, "text/plain; charset=utf-8", "MQTT地址已更新 / MQTT address updated");
+      LOG_I(LOG_MQTT_ADDRESS_UPDATED, mqtt_server);
+      sendTextMessage(200, MSG_MQTT_ADDRESS_UPDATED);
     } else {
-      server.send(400, "text/plain; charset=utf-8", "地址过长 / Address too long");
-      Serial.println("设置MQTT地址失败：地址过长 / Failed to set MQTT address: Address too long");
+      sendTextMessage(400, MSG_ADDRESS_TOO_LONG);
+      LOG_W(LOG_MQTT_ADDRESS_TOO_LONG);
     }
   } else {
-    server.send(400, "text/plain; charset=utf-8", "缺少地址参数 / Missing address parameter");
-    Serial.println("设置MQTT地址失败：缺少地址参数 / Failed to set MQTT address: Missing address parameter");
+    sendTextMessage(400, MSG_MISSING_ADDRESS);
+    LOG_W(LOG_MQTT_ADDRESS_MISSING);
   }
 }
 
@@ -175,6 +693,7 @@ const unsigned long debounceDelay = 50; // 防抖延迟（毫秒） / Debounce d
 // MQTT主题定义 / MQTT topic definitions
 const char* mqtt_topic_motor_control = "motor/control"; // 电机控制主题 / Motor control topic
 const char* mqtt_topic_status_report = "motor/status";  // 状态上报主题 / Status report topic
+const char* mqtt_topic_telemetry = "motor/telemetry"; // CBOR遥测主题（保留消息） / CBOR telemetry topic (retained)
 
 // 电机状态变量 / Motor state variables
 bool motorEnabled = false; // 电机是否开启 / Whether the motor is enabled
@@ -183,6 +702,7 @@ bool motorDirection = true; // 电机方向：true为正转，false为反转 / M
 // 电机启动时长（毫秒） / Motor run duration (milliseconds)
 unsigned long motorRunDuration = 10000; // 默认10秒 / Default 10 seconds
 unsigned long motorStartTime = 0; // 电机启动时间戳 / Motor start timestamp
+unsigned long motorStepsRemaining = 0; // 定长运行剩余步数，0 表示持续运行 / Steps left in a counted run, 0 means run continuously
 
 // 电机未使用超时时间（毫秒） / Motor inactivity timeout (milliseconds)
 const unsigned long motorInactivityTimeout = 5 * 60 * 1000; // 5 分钟 / 5 minutes
@@ -200,13 +720,14 @@ unsigned long lastControllerCheckTime = 0; // 上次检测时间戳 / Last check
 
 // 控制端信息存储 / Client information storage
 std::map<String, String> clients; // 存储控制端MAC地址和名称 / Store client MAC address and name
+unsigned long clientsVersion = 0; // 控制端登记表版本，内容变化时加一 / Client registry version, bumped on every change
 
 // 动态记录控制端MAC地址 / Dynamically record controller MAC addresses
 void handleRegisterController() {
   String macAddress = WiFi.macAddress();
-  Serial.println("控制端已注册，MAC地址: / Controller registered, MAC address: " + macAddress);
+  LOG_I(LOG_CONTROLLER_REGISTERED, macAddress);
   controllerOnline = true; // 设置控制端上线标志 / Set controller online flag
-  server.send(200, "text/plain", "控制端已注册 / Controller registered");
+  sendTextMessage(200, MSG_CONTROLLER_REGISTERED);
 }
 
 // MQTT消息回调函数声明 / MQTT message callback function declaration
@@ -214,6 +735,16 @@ void mqttCallback(char* topic, byte* payload, unsigned int length);
 
 // 定义MQTT重连的时间间隔（毫秒） / Define MQTT reconnect interval (milliseconds)
 const unsigned long mqttReconnectInterval = 5000; // 每5秒尝试一次 / Retry every 5 seconds
+// MQTT连接分步进行（TCP连接、发送CONNECT、等待CONNACK），每轮主循环只推进一步，服务器无响应时不会卡住电机。
+// 只有TCP连接这一步是阻塞调用，其时长由 espClient 的超时限制。
+// MQTT connects in steps (TCP connect, CONNECT send, CONNACK wait), one step per loop pass, so an unresponsive broker
+// does not stall the motor. Only the TCP connect is a blocking call, bounded by the espClient timeout.
+#ifndef MQTT_TCP_CONNECT_TIMEOUT_MS
+#define MQTT_TCP_CONNECT_TIMEOUT_MS 1000 // TCP连接最长阻塞时间 / Longest blocking time of the TCP connect
+#endif
+#ifndef MQTT_CONNACK_TIMEOUT_S
+#define MQTT_CONNACK_TIMEOUT_S 5 // 发送CONNECT和等待CONNACK各自的超时（秒） / Timeout of the CONNECT send and the CONNACK wait each (s)
+#endif
 unsigned long lastMQTTReconnectAttempt = 0; // 上次尝试时间戳 / Last reconnect attempt timestamp
 
 // MQTT控制启用标志 / MQTT control enable flag
@@ -222,210 +753,47 @@ bool mqttControlEnabled = false; // 默认禁用MQTT控制 / Default to disabled
 // MQTT重连函数 / MQTT reconnect function
 void reconnectMQTT() {
   if (!mqttControlEnabled) {
-    Serial.println("MQTT控制已禁用，跳过重连 / MQTT control disabled, skipping reconnect");
+    LOG_D(LOG_MQTT_RECONNECT_DISABLED);
     return;
   }
 
   if (client.connected()) return; // 如果已连接，直接返回 / Return if already connected
+  if (WiFi.status() != WL_CONNECTED) return; // WiFi未就绪时不尝试连接 / Do not try while WiFi is not up
+
+  // 连接进行中：推进一步 / Connect in progress: advance one step
+  if (client.connecting()) {
+    int rc = client.connectStep();
+    if (rc == MQTT_CONNECTING) return;
+    if (rc == MQTT_CONNECTED) {
+      markBootPhase(BOOT_PHASE_MQTT);
+      LOG_I(LOG_MQTT_CONNECTED);
+      client.subscribe(mqtt_topic_motor_control); // 订阅电机控制主题 / Subscribe to motor control topic
+      client.subscribe("motor/step_once"); // 新增订阅单步运行主题
+    } else {
+      LOG_W(LOG_MQTT_CONNECT_FAILED, rc);
+    }
+    return;
+  }
 
   unsigned long now = millis();
   if (!controllerOnline) {
     // 限制串口输出频率 / Limit serial output frequency
     if (now - lastControllerCheckTime >= controllerCheckInterval) {
       lastControllerCheckTime = now; // 更新上次检测时间戳 / Update last check timestamp
-      Serial.println("控制端未上线，跳过MQTT连接 / Controller not online, skipping MQTT connection");
+      LOG_D(LOG_MQTT_CONTROLLER_OFFLINE);
     }
     return;
   }
 
   if (now - lastMQTTReconnectAttempt >= mqttReconnectInterval) {
     lastMQTTReconnectAttempt = now; // 更新上次尝试时间戳 / Update last attempt timestamp
-    Serial.print("尝试连接MQTT服务器... / Attempting to connect to MQTT server...");
-    if (client.connect("ESP8266Client")) {
-      Serial.println("连接成功 / Connected");
-      client.subscribe(mqtt_topic_motor_control); // 订阅电机控制主题 / Subscribe to motor control topic
-      client.subscribe("motor/step_once"); // 新增订阅单步运行主题
-    } else {
-      Serial.print("连接失败，状态码= / Connection failed, state=");
-      Serial.println(client.state());
+    LOG_D(LOG_MQTT_CONNECTING, mqtt_server);
+    if (!client.startConnect("ESP8266Client")) {
+      LOG_W(LOG_MQTT_CONNECT_FAILED, client.state());
     }
   }
 }
 
-// 嵌入的HTML内容 / Embedded HTML content
-const char MAIN_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-  <meta charset="UTF-8">
-  <title>ESP8266 步进电机控制系统</title>
-  <style>
-    body { font-family: Arial, sans-serif; text-align: center; margin: 20px; }
-    h1 { color: #333; }
-    button, input[type="text"], input[type="number"] { padding: 10px 20px; margin: 10px; font-size: 16px; }
-    button { background-color: #4CAF50; color: white; border: none; cursor: pointer; }
-    button:hover { background-color: #45a049; }
-    input[type="text"], input[type="number"] { width: 300px; }
-    .info { margin: 20px; font-size: 18px; }
-    .button-group { margin: 20px; }
-  </style>
-  <script>
-    // 加载设备信息 / Load device information
-    function loadDeviceInfo() {
-      fetch('/api/device_info')
-        .then(response => response.json())
-        .then(data => {
-          document.getElementById('ipAddress').innerText = data.ip;
-          document.getElementById('macAddress').innerText = data.mac;
-          document.getElementById('version').innerText = data.version;
-          document.getElementById('onlineClients').innerText = data.onlineClients;
-        })
-        .catch(() => alert('无法加载设备信息 / Failed to load device information'));
-    }
-
-    // 设置电机启动时长 / Set motor run duration
-    function setMotorDuration() {
-      const duration = document.getElementById('motorDuration').value;
-      fetch(`/api/set_motor_duration?duration=${duration}`)
-        .then(response => {
-          if (response.ok) {
-            alert('电机启动时长已更新！ / Motor run duration updated!');
-          } else {
-            alert('设置失败，请检查输入值 / Failed to set duration, please check the input value');
-          }
-        })
-        .catch(() => alert('无法连接到设备 / Unable to connect to the device'));
-    }
-
-    // 设置MQTT地址 / Set MQTT address
-    function setMQTTAddress() {
-      const address = document.getElementById('mqttAddress').value;
-      fetch(`/api/set_mqtt?address=${encodeURIComponent(address)}`)
-        .then(response => {
-          if (response.ok) {
-            alert('MQTT地址已更新！ / MQTT address updated!');
-          } else {
-            alert('设置失败，请检查输入值 / Failed to set MQTT address, please check the input value');
-          }
-        })
-        .catch(() => alert('无法连接到设备 / Unable to connect to the device'));
-    }
-
-    // 切换MQTT控制 / Toggle MQTT control
-    function toggleMQTTControl(enable) {
-      const url = `/api/mqtt_control?enable=${enable}`;
-      fetch(url)
-        .then(response => {
-          if (response.ok) {
-            alert(enable ? 'MQTT控制已启用！' : 'MQTT控制已禁用！');
-          } else {
-            alert('操作失败，请检查设备状态 / Operation failed, please check device status');
-          }
-        })
-        .catch(() => alert('无法连接到设备 / Unable to connect to the device'));
-    }
-
-    // 重新进入配网模式 / Reset WiFi configuration
-    function resetWiFi() {
-      fetch('/api/reset_wifi')
-        .then(response => {
-          if (response.ok) {
-            alert('设备正在重新进入配网模式 / Device is restarting to enter configuration mode');
-          } else {
-            alert('操作失败，请检查设备状态 / Operation failed, please check device status');
-          }
-        })
-        .catch(() => alert('无法连接到设备 / Unable to connect to the device'));
-    }
-
-    // 加速电机 / Speed up motor
-    function speedUpMotor() {
-      fetch('/motor/speed_up')
-        .then(response => {
-          if (response.ok) {
-            alert('电机加速成功！ / Motor speed increased successfully!');
-          } else {
-            alert('加速失败！ / Speed up failed!');
-          }
-        })
-        .catch(() => alert('无法连接到设备 / Unable to connect to the device'));
-    }
-
-    // 减速电机 / Slow down motor
-    function slowDownMotor() {
-      fetch('/motor/slow_down')
-        .then(response => {
-          if (response.ok) {
-            alert('电机减速成功！ / Motor speed decreased successfully!');
-          } else {
-            alert('减速失败！ / Slow down failed!');
-          }
-        })
-        .catch(() => alert('无法连接到设备 / Unable to connect to the device'));
-    }
-
-    // 单步运行
-    function stepOnce() {
-      fetch('/motor/step_once')
-        .then(response => {
-          if (response.ok) {
-            alert('单步运行已执行！ / Step motor once executed!');
-          } else {
-            alert('单步运行失败！ / Step motor once failed!');
-          }
-        })
-        .catch(() => alert('无法连接到设备 / Unable to connect to the device'));
-    }
-
-    window.onload = loadDeviceInfo;
-  </script>
-</head>
-<body>
-  %MICROSTEP_OPTIONS%
-  <h1>ESP8266 步进电机控制系统</h1>
-  <div class="info">
-    <p>设备IP地址: <strong id="ipAddress"></strong></p>
-    <p>设备MAC地址: <strong id="macAddress"></strong></p>
-    <p>固件版本: <strong id="version"></strong></p>
-    <p>在线控制端数量: <strong id="onlineClients"></strong></p>
-    <button onclick="location.href='/clients'">查看控制端信息</button>
-  </div>
-  <div class="button-group">
-    <h2>电机控制</h2>
-    <button onclick="fetch('/motor/on').then(() => alert('电机已开启！')).catch(() => alert('操作失败！'));">开启电机</button>
-    <button onclick="fetch('/motor/off').then(() => alert('电机已关闭！')).catch(() => alert('操作失败！'));">关闭电机</button>
-    <button onclick="fetch('/motor/direction').then(() => alert('电机方向已切换！')).catch(() => alert('操作失败！'));">切换电机方向</button>
-    <button onclick="speedUpMotor()">加速</button>
-    <button onclick="slowDownMotor()">减速</button>
-    <button onclick="stepOnce()">单步运行</button>
-  </div>
-  <div class="button-group">
-    <h2>设置电机启动时长</h2>
-    <input type="number" id="motorDuration" placeholder="输入时长（秒）" min="1" max="1800" required>
-    <button onclick="setMotorDuration()">设置时长</button>
-  </div>
-  <div class="button-group">
-    <h2>设置 MQTT 地址</h2>
-    <input type="text" id="mqttAddress" placeholder="输入MQTT服务器地址" required>
-    <button onclick="setMQTTAddress()">更新地址</button>
-  </div>
-  <div class="button-group">
-    <h2>MQTT 控制</h2>
-    <button onclick="toggleMQTTControl(true)">启用 MQTT 控制</button>
-    <button onclick="toggleMQTTControl(false)">禁用 MQTT 控制</button>
-  </div>
-  <div class="button-group">
-    <h2>OTA 升级</h2>
-    <button onclick="location.href='/ota'">开始OTA升级</button>
-  </div>
-  <div class="button-group">
-    <h2>WiFi 配置</h2>
-    <button onclick="resetWiFi()">重新进入配网模式</button>
-  </div>
-</body>
-</html>
-)rawliteral";
-
 // 获取当前时间戳（毫秒） / Get current timestamp (milliseconds)
 unsigned long getTimestamp() {
   return millis();
@@ -434,7 +802,7 @@ unsigned long getTimestamp() {
 // 更新电机活动时间戳 / Update motor activity timestamp
 void updateMotorActivity() {
   lastMotorActivityTime = millis();
-  Serial.printf("[%lu] 电机活动时间已更新 / Motor activity timestamp updated\n", lastMotorActivityTime);
+  LOG_D(LOG_MOTOR_ACTIVITY);
 }
 
 // 检查电机未使用超时 / Check motor inactivity timeout
@@ -442,8 +810,228 @@ void checkMotorInactivity() {
   if (motorEnabled && (millis() - lastMotorActivityTime >= motorInactivityTimeout)) {
     motorEnabled = false;
     digitalWrite(ENABLE_PIN, HIGH); // 禁用电机 / Disable motor
-    Serial.printf("[%lu] 电机因未使用超时已禁用 / Motor disabled due to inactivity timeout\n", millis());
+    LOG_I(LOG_MOTOR_INACTIVITY_OFF);
+  }
+}
+
+// 空闲节流相关变量 / Idle throttling state
+// 电机关闭且一段时间无活动时，loop() 末尾按有界时长休眠，让出CPU并允许WiFi进入调制解调器休眠
+// When the motor is off and nothing happened for a while, loop() sleeps for bounded slices so the CPU and radio can rest
+const unsigned long idleEnterDelay = 2000; // 无活动多久后进入空闲模式（毫秒） / No-activity time before idling (milliseconds)
+// 单次空闲休眠上限（毫秒）；按钮和网络事件在下一个1毫秒切片结束休眠 / Max sleep per pass (ms); buttons and network events
+// end it at the next 1 ms slice
+const unsigned long idleSliceMax = 20;
+// 按钮中断、HTTP的lwIP回调、WebSocket事件和MQTT待读数据置位，立即恢复全速轮询
+// Set by the button ISR, the HTTP lwIP callbacks, WebSocket events and pending MQTT data to resume full-rate polling
+volatile bool idleWakeRequested = false;
+unsigned long lastActivityTime = 0; // 上次活动时间戳 / Last activity timestamp
+bool idleModeActive = false; // 当前是否处于空闲模式 / Whether idle mode is active
+unsigned long idleEnterCount = 0; // 进入空闲模式的次数 / Number of idle mode entries
+unsigned long long idleSleepMicros = 0; // 累计休眠时间（微秒） / Accumulated sleep time (microseconds)
+
+// 主循环耗时统计（不含空闲休眠），用于比较不同日志级别的开销 / Loop work time (idle sleep excluded), used to compare log levels
+unsigned long loopCount = 0; // 主循环次数 / Loop passes
+unsigned long long loopWorkMicros = 0; // 累计处理时间（微秒） / Accumulated work time (microseconds)
+unsigned long loopWorkMaxMicros = 0; // 单次最长处理时间（微秒） / Longest single pass (microseconds)
+
+// 按钮中断：只置位唤醒标志 / Button interrupt: only raise the wake flag
+IRAM_ATTR void onButtonInterrupt() {
+  idleWakeRequested = true;
+}
+
+// 记录活动，退出空闲模式 / Record activity and leave idle mode
+void noteActivity() {
+  lastActivityTime = millis();
+  idleModeActive = false;
+}
+
+// 空闲节流：电机关闭且无待处理事件时按1毫秒切片休眠，按钮或网络事件可立即打断
+// Idle throttling: sleep in 1 ms slices while the motor is off and nothing is pending; a button or network event cuts
+// it short
+void idleThrottle() {
+  if (idleWakeRequested) {
+    idleWakeRequested = false;
+    noteActivity();
+    return;
+  }
+  if (motorEnabled || millis() - lastActivityTime < idleEnterDelay) {
+    idleModeActive = false;
+    return;
+  }
+  if (!idleModeActive) {
+    idleModeActive = true;
+    idleEnterCount++;
+  }
+
+  unsigned long sleepStart = micros();
+  for (unsigned long slice = 0; slice < idleSliceMax && !idleWakeRequested; slice++) {
+    logDrain(); // 休眠间隙输出日志 / Drain logs between sleep slices
+    idlePollNetwork();
+    if (idleWakeRequested) break;
+    delay(1); // delay() 让出给SDK，允许自动调制解调器休眠 / delay() yields to the SDK and allows automatic modem sleep
+  }
+  idleSleepMicros += micros() - sleepStart;
+}
+
+// =============================
+// 主循环卡顿检测 / Loop stall watchdog
+// =============================
+// loop() 在调用每个子系统前标记当前子系统；timer1 中断每10毫秒检查一次，本轮处理超过阈值时把子系统、持续时间
+// 和被中断处的PC采样直接写入RTC内存。卡顿中发生看门狗或软件复位时，记录在下次启动后仍然可读。
+// loop() marks the running subsystem before each call. A timer1 interrupt checks every 10 ms; once a pass exceeds the
+// threshold it writes the subsystem, duration and PC samples of the interrupted code straight into RTC memory, so a
+// stall that ends in a watchdog or software reset is still readable after the next boot.
+enum StallSubsystem : uint8_t {
+  STALL_NONE,    // 不在处理中（空闲休眠） / Outside a pass (idle sleep)
+  STALL_WIFI,    // updateWiFi()
+  STALL_CONTROL, // LED、电机按钮、运行时长、超时检查 / LED, motor button, run duration, inactivity check
+  STALL_STEPPER, // runStepper()
+  STALL_BUTTONS, // handlePhysicalButtons()
+  STALL_MQTT,    // 重连与 client.loop() / Reconnect and client.loop()
+  STALL_WEB,     // server.handleClient()
+  STALL_OTA,     // OTA升级 / OTA update
+  STALL_LOG,     // logDrain()
+  STALL_SUBSYSTEM_COUNT
+};
+
+const char* const STALL_SUBSYSTEM_NAMES[STALL_SUBSYSTEM_COUNT] = {
+  "none", "wifi", "control", "stepper", "buttons", "mqtt", "web", "ota", "log"
+};
+
+#define STALL_RTC_OFFSET 43 // RTC用户内存块偏移，位于WiFi缓存（32-42）之后 / RTC user memory block offset, after the WiFi cache (32-42)
+#define STALL_RING_SIZE 8 // 保留的卡顿记录数 / Stall records kept
+#define STALL_PC_SAMPLES 4 // 每条记录的PC采样数 / PC samples per record
+#define STALL_MAGIC 0x53544C4C // "STLL"
+#define RTC_USER_MEM ((volatile uint32_t*)0x60001200) // RTC用户内存映射地址（与eboot相同） / Memory-mapped RTC user memory (as used by eboot)
+
+// RTC内存只支持32位访问，所有字段均为 uint32_t / RTC memory only supports 32-bit access, so every field is uint32_t
+struct StallRecord {
+  uint32_t boot; // 第几次启动 / Boot number
+  uint32_t subsystem; // StallSubsystem
+  uint32_t uptimeMs; // 卡顿开始时的运行时间 / Uptime when the stall began
+  uint32_t durationMs; // 卡顿持续时间 / Stall duration
+  uint32_t open; // 1=卡顿中复位，持续时间为复位前最后一次采样 / 1 = reset during the stall, duration is the last sample
+  uint32_t pc[STALL_PC_SAMPLES]; // 被中断处的PC，每10毫秒一个 / Interrupted PC, one per 10 ms
+};
+
+struct StallLog {
+  uint32_t magic;
+  uint32_t bootCount;
+  uint32_t head; // 下一条写入位置 / Next record slot
+  uint32_t count; // 已保存记录数 / Records stored
+  StallRecord records[STALL_RING_SIZE];
+};
+static_assert(STALL_RTC_OFFSET * 4 + sizeof(StallLog) <= 512, "stall log must fit in RTC user memory");
+
+volatile StallLog* const stallLog = (volatile StallLog*)(RTC_USER_MEM + STALL_RTC_OFFSET);
+
+const unsigned long stallThresholdMs = 100; // 单轮处理超过该时长视为卡顿（毫秒） / Pass time counted as a stall (milliseconds)
+const uint32_t stallTimerTicks = 3125; // 10毫秒（80MHz / 256） / 10 ms at 80 MHz / 256
+volatile uint8_t stallSubsystem = STALL_NONE; // 当前运行的子系统 / Subsystem currently running
+volatile uint32_t stallPassStart = 0; // 本轮开始时间（微秒） / Pass start (microseconds)
+volatile bool stallActive = false; // 本轮已判定为卡顿 / Current pass is a stall
+volatile uint8_t stallPcCount = 0; // 本次卡顿已采样数 / PC samples taken for this stall
+uint32_t stallMarkTime = 0; // 上次标记时间（微秒） / Time of the last mark (microseconds)
+uint32_t stallSubsystemMicros[STALL_SUBSYSTEM_COUNT]; // 本轮各子系统耗时 / Time per subsystem in this pass
+unsigned long stallDetectedCount = 0; // 本次启动检测到的卡顿数 / Stalls detected since boot
+
+// 标记当前子系统，并把上一段耗时计入上一个子系统 / Mark the running subsystem and charge the elapsed time to the previous one
+inline void stallMark(StallSubsystem subsystem) {
+  uint32_t now = micros();
+  stallSubsystemMicros[stallSubsystem] += now - stallMarkTime;
+  stallMarkTime = now;
+  stallSubsystem = subsystem;
+}
+
+// timer1 中断：本轮超时则打开或更新RTC中的记录 / timer1 interrupt: open or update the RTC record once the pass overruns
+IRAM_ATTR void onStallTimer() {
+  uint8_t subsystem = stallSubsystem;
+  if (subsystem == STALL_NONE) return;
+  uint32_t elapsedMs = (micros() - stallPassStart) / 1000;
+  if (elapsedMs < stallThresholdMs) return;
+
+  volatile StallRecord& rec = stallLog->records[stallLog->head];
+  if (!stallActive) {
+    stallActive = true;
+    stallPcCount = 0;
+    rec.boot = stallLog->bootCount;
+    rec.subsystem = subsystem;
+    rec.uptimeMs = millis() - elapsedMs;
+    rec.open = 1;
+    for (int i = 0; i < STALL_PC_SAMPLES; i++) rec.pc[i] = 0;
+  }
+  rec.durationMs = elapsedMs;
+  if (stallPcCount < STALL_PC_SAMPLES) {
+    uint32_t pc;
+    asm volatile("rsr %0, epc1" : "=r"(pc)); // 被中断指令的地址 / Address of the interrupted instruction
+    rec.pc[stallPcCount++] = pc;
+  }
+}
+
+// 提交当前记录到环形缓冲区 / Commit the current record to the ring
+void stallCommit() {
+  stallLog->head = (stallLog->head + 1) % STALL_RING_SIZE;
+  if (stallLog->count < STALL_RING_SIZE) stallLog->count++;
+}
+
+// 一轮处理开始 / A pass begins
+void stallPassBegin() {
+  memset(stallSubsystemMicros, 0, sizeof(stallSubsystemMicros));
+  stallMarkTime = micros();
+  stallPassStart = stallMarkTime;
+}
+
+// 一轮处理结束：如判定为卡顿，按耗时最长的子系统归因并提交 / A pass ends: if it stalled, blame the slowest subsystem and commit
+void stallPassEnd() {
+  stallMark(STALL_NONE); // 先停止中断侧的更新 / Stop interrupt-side updates first
+  if (!stallActive) return;
+
+  volatile StallRecord& rec = stallLog->records[stallLog->head];
+  uint8_t culprit = rec.subsystem;
+  for (uint8_t i = STALL_NONE + 1; i < STALL_SUBSYSTEM_COUNT; i++) {
+    if (stallSubsystemMicros[i] > stallSubsystemMicros[culprit]) culprit = i;
+  }
+  rec.subsystem = culprit;
+  rec.durationMs = (stallMarkTime - stallPassStart) / 1000;
+  rec.open = 0;
+  stallCommit();
+  stallActive = false;
+  stallDetectedCount++;
+  LOG_W(LOG_STALL_DETECTED, STALL_SUBSYSTEM_NAMES[culprit], (unsigned long)rec.durationMs);
+}
+
+// 休眠切片之间检查HTTP以外的网络：MQTT查看套接字中的待读数据；WebSocketsServer不公开套接字，只能轮询一次，
+// 有事件时其回调会置位唤醒标志。轮询按一轮处理计入卡顿检测
+// Between sleep slices, check the network beyond HTTP: MQTT looks for unread data on its socket; WebSocketsServer does
+// not expose its sockets, so it is polled once and its event callback raises the wake flag. The poll counts as a pass
+// for the stall watchdog
+void idlePollNetwork() {
+  if (mqttControlEnabled && espClient.available() > 0) idleWakeRequested = true;
+  stallPassBegin();
+  stallMark(STALL_WEB);
+  webSocket.loop();
+  stallPassEnd();
+}
+
+// 启动时初始化卡顿记录并开启定时器 / Initialize the stall log at boot and start the timer
+void initializeStallWatchdog() {
+  if (stallLog->magic != STALL_MAGIC || stallLog->head >= STALL_RING_SIZE || stallLog->count > STALL_RING_SIZE) {
+    // 上电后RTC内存内容随机，重新初始化 / RTC memory is random after power-up, start over
+    volatile uint32_t* words = (volatile uint32_t*)stallLog;
+    for (size_t i = 0; i < sizeof(StallLog) / 4; i++) words[i] = 0;
+    stallLog->magic = STALL_MAGIC;
+  }
+  // 上次运行在卡顿中复位，保留这条未完成的记录 / The last run reset during a stall, keep the unfinished record
+  volatile StallRecord& last = stallLog->records[stallLog->head];
+  if (last.open == 1 && last.boot == stallLog->bootCount && last.subsystem < STALL_SUBSYSTEM_COUNT) {
+    LOG_W(LOG_STALL_RESET, STALL_SUBSYSTEM_NAMES[last.subsystem], (unsigned long)last.durationMs);
+    stallCommit();
   }
+  stallLog->bootCount++;
+
+  timer1_attachInterrupt(onStallTimer);
+  timer1_enable(TIM_DIV256, TIM_EDGE, TIM_LOOP);
+  timer1_write(stallTimerTicks);
 }
 
 // LED 状态变量 / LED state variables
@@ -469,65 +1057,527 @@ void updateLEDState() {
     }
 }
 
-// 初始化WiFi连接 / Initialize WiFi connection with fault tolerance
+// WiFi启动状态机 / WiFi bring-up state machine
+// 由 loop() 推进，连接过程中按钮和步进电机始终可用
+// Advanced by loop() so buttons and the stepper stay live while the network comes up
+enum WiFiBringupState {
+  WIFI_STATE_CONNECTING, // 使用保存的凭据连接中 / Connecting with saved credentials
+  WIFI_STATE_BACKOFF,    // 连接失败，等待重试 / Connection failed, waiting to retry
+  WIFI_STATE_PORTAL,     // 智能配网门户运行中 / Smart configuration portal running
+  WIFI_STATE_VERIFYING,  // 使用缓存IP快速连接后确认网关可达 / Confirming the gateway after a fast connect on the cached IP
+  WIFI_STATE_CONNECTED   // 已连接 / Connected
+};
+
+WiFiManager wifiManager; // 智能配网对象（非阻塞模式） / Smart configuration manager (non-blocking mode)
+WiFiBringupState wifiState = WIFI_STATE_CONNECTING; // 当前WiFi状态 / Current WiFi state
+unsigned long wifiStateSince = 0; // 进入当前状态的时间戳 / Timestamp of entering the current state
+const unsigned long wifiConnectTimeout = 20000; // 单次连接超时（毫秒） / Per-attempt connect timeout (milliseconds)
+const unsigned long wifiRetryDelay = 10000; // 失败后重试间隔（毫秒） / Retry delay after a failure (milliseconds)
+const int wifiMaxFailures = 3; // 连续失败多少次后进入配网模式 / Failures before entering configuration mode
+bool networkServicesStarted = false; // 首次联网后启动的服务（OTA）是否已启动 / Whether services started on first connection (OTA) are up
+
+void startNetworkServices(); // 首次联网后启动OTA等服务 / Start OTA and other services after the first connection
+
+// WiFi快速连接缓存：上次成功连接的BSSID、信道和IP配置，同时保存在RTC内存和EEPROM中。
+// 缓存的IP只在DHCP租约过半（T1，DHCP客户端本该续租的时间）之前沿用，否则仍定向连接BSSID和信道，但IP改由DHCP分配。
+// 租约按设备时钟计时：设备时钟保存在RTC内存中，软复位后接着计时；断电后时钟未知，从EEPROM加载的缓存不沿用IP。
+// WiFi fast-connect cache: BSSID, channel and IP configuration of the last good connection, kept in RTC memory and EEPROM.
+// The cached IP is reused only before half the DHCP lease has passed (T1, when the DHCP client would renew); after
+// that the BSSID and channel are still pinned but the IP comes from DHCP. The lease is timed on a device clock kept in
+// RTC memory, which carries on across soft resets; after a power cycle the clock is unknown, so a cache loaded from
+// EEPROM never reuses the IP.
+#define WIFI_CACHE_MAGIC 0x57494643 // "WIFC"
+struct WiFiFastConnectCache {
+  uint32_t magic;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t reserved;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint32_t leaseSeconds; // DHCP租约时长，0表示未知 / DHCP lease time, 0 when unknown
+  uint32_t leaseObtained; // 获得租约时的设备时钟（秒） / Device clock when the lease was obtained (s)
+  uint32_t clock; // 保存时的设备时钟（秒） / Device clock at the save (s)
+  uint32_t crc; // 以上字段的CRC32 / CRC32 of the fields above
+};
+static_assert(WIFI_CACHE_RTC_OFFSET * 4 + sizeof(WiFiFastConnectCache) <= STALL_RTC_OFFSET * 4,
+              "WiFi cache must end before the stall log");
+
+WiFiFastConnectCache wifiCache; // 当前缓存 / Current cache
+const unsigned long wifiFastConnectTimeout = 5000; // 定向快速连接超时（毫秒） / Directed fast-connect timeout (milliseconds)
+bool wifiFastConnectActive = false; // 当前连接是否为快速连接 / Whether the current attempt is a fast connect
+bool wifiUsingCachedIp = false; // 当前是否使用缓存的静态IP / Whether the cached IP is applied as a static address
+uint32_t wifiClockBase = 0; // 设备时钟在本次启动时的起点（秒） / Device clock at this boot (s)
+unsigned long wifiCacheSavedAt = 0; // 上次刷新RTC缓存的时间 / Last refresh of the RTC cache
+const unsigned long wifiCacheRefreshInterval = 10000; // 连接期间刷新RTC缓存（时钟和租约）的间隔（毫秒） / RTC cache (clock and lease) refresh interval while connected (ms)
+const unsigned long wifiLinkCheckTimeout = 1500; // 网关ARP检查超时（毫秒） / Gateway ARP check timeout (ms)
+const unsigned long wifiLinkCheckInterval = 300; // ARP请求重发间隔（毫秒） / ARP request resend interval (ms)
+unsigned long wifiLinkCheckProbes = 0; // 已发送的ARP请求数 / ARP requests sent
+unsigned long wifiConnectStartTime = 0; // 本轮连接开始时间 / Start of the current connection round
+unsigned long wifiTimeToConnect = 0; // 最近一次连接耗时（毫秒） / Duration of the last connection (milliseconds)
+bool wifiLastConnectWasFast = false; // 最近一次连接是否走快速路径 / Whether the last connection used the fast path
+unsigned long wifiFastConnectAttempts = 0; // 快速连接尝试次数 / Fast-connect attempts
+unsigned long wifiFastConnectSuccesses = 0; // 快速连接成功次数 / Fast-connect successes
+
+uint32_t wifiCacheCrc(const WiFiFastConnectCache& cache) {
+  return crc32(&cache, offsetof(WiFiFastConnectCache, crc));
+}
+
+bool wifiCacheValid(const WiFiFastConnectCache& cache) {
+  return cache.magic == WIFI_CACHE_MAGIC && cache.crc == wifiCacheCrc(cache) && cache.channel != 0;
+}
+
+// 设备时钟（秒），软复位后从RTC缓存中保存的值继续 / Device clock (s), resumed from the RTC cache after a soft reset
+uint32_t wifiClock() {
+  return wifiClockBase + (uint32_t)(micros64() / 1000000);
+}
+
+// 缓存的IP是否仍在租约前半段内 / Whether the cached IP is still within the first half of its lease
+bool wifiLeaseValid() {
+  return wifiCache.leaseSeconds != 0 && wifiCache.gateway != 0 &&
+         wifiClock() - wifiCache.leaseObtained < wifiCache.leaseSeconds / 2;
+}
+
+// 加载缓存：优先RTC内存（软复位后保留），其次EEPROM（断电后保留，租约未知）
+// Load the cache: RTC memory first (kept across soft resets), then EEPROM (kept across power cycles, lease unknown)
+bool loadWiFiCache() {
+  ESP.rtcUserMemoryRead(WIFI_CACHE_RTC_OFFSET, (uint32_t*)&wifiCache, sizeof(wifiCache));
+  if (wifiCacheValid(wifiCache)) {
+    wifiClockBase = wifiCache.clock;
+    return true;
+  }
+  EEPROM.get(WIFI_CACHE_EEPROM_ADDR, wifiCache);
+  if (!wifiCacheValid(wifiCache)) return false;
+  wifiCache.leaseSeconds = 0; // 断电期间的时间未知 / Time spent powered off is unknown
+  wifiCache.crc = wifiCacheCrc(wifiCache);
+  ESP.rtcUserMemoryWrite(WIFI_CACHE_RTC_OFFSET, (uint32_t*)&wifiCache, sizeof(wifiCache));
+  return true;
+}
+
+// 查找STA网络接口 / Find the station network interface
+struct netif* stationNetif() {
+  for (struct netif* n = netif_list; n; n = n->next) {
+    if (n->num == STATION_IF) return n;
+  }
+  return nullptr;
+}
+
+// 保存缓存并记录DHCP租约；RTC每次写入，EEPROM只在网络参数变化时写入（租约和时钟断电后无意义）
+// Save the cache with the DHCP lease; RTC is written every time, EEPROM only when the network part changes (the lease
+// and clock mean nothing after a power cycle)
+void saveWiFiCache() {
+  WiFiFastConnectCache cache = {};
+  cache.magic = WIFI_CACHE_MAGIC;
+  memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+  cache.channel = WiFi.channel();
+  cache.ip = WiFi.localIP();
+  cache.gateway = WiFi.gatewayIP();
+  cache.subnet = WiFi.subnetMask();
+  cache.dns = WiFi.dnsIP();
+  struct netif* sta = stationNetif();
+  if (sta && dhcp_supplied_address(sta)) {
+    const struct dhcp* dhcp = netif_dhcp_data(sta);
+    cache.leaseSeconds = dhcp->offered_t0_lease;
+    cache.leaseObtained = wifiClock() - dhcp->lease_used * DHCP_COARSE_TIMER_SECS;
+  } else if (wifiUsingCachedIp) {
+    // 沿用缓存IP期间没有DHCP，租约保持原值 / No DHCP runs while on the cached IP, keep the original lease
+    cache.leaseSeconds = wifiCache.leaseSeconds;
+    cache.leaseObtained = wifiCache.leaseObtained;
+  }
+  cache.clock = wifiClock();
+  cache.crc = wifiCacheCrc(cache);
+  ESP.rtcUserMemoryWrite(WIFI_CACHE_RTC_OFFSET, (uint32_t*)&cache, sizeof(cache));
+  wifiCacheSavedAt = millis();
+  bool networkChanged = memcmp(&cache, &wifiCache, offsetof(WiFiFastConnectCache, leaseSeconds)) != 0;
+  wifiCache = cache;
+  if (networkChanged) {
+    EEPROM.put(WIFI_CACHE_EEPROM_ADDR, wifiCache);
+    EEPROM.commit();
+    LOG_D(LOG_WIFI_CACHE_UPDATED);
+  }
+}
+
+// 使RTC中的缓存失效，避免软复位后重复失败的快速连接 / Invalidate the RTC copy so a soft reset does not repeat a failed fast connect
+void invalidateWiFiCache() {
+  wifiCache.magic = 0;
+  ESP.rtcUserMemoryWrite(WIFI_CACHE_RTC_OFFSET, (uint32_t*)&wifiCache, sizeof(wifiCache));
+}
+
+// 切换WiFi状态 / Switch WiFi state
+void setWiFiState(WiFiBringupState state) {
+  wifiState = state;
+  wifiStateSince = millis();
+}
+
+// 开始一次使用保存凭据的完整连接（扫描+DHCP） / Start a full connection attempt (scan + DHCP) with saved credentials
+void beginWiFiConnect() {
+  wifiFastConnectActive = false;
+  wifiUsingCachedIp = false;
+  WiFi.config(0U, 0U, 0U); // 恢复DHCP / Restore DHCP
+  WiFi.persistent(false); // 凭据已保存，不重复写闪存 / Credentials are already saved, do not rewrite flash
+  WiFi.begin(WiFi.SSID(), WiFi.psk()); // 不指定BSSID和信道 / No BSSID or channel pinned
+  WiFi.persistent(true);
+  setWiFiState(WIFI_STATE_CONNECTING);
+}
+
+// 使用缓存的BSSID和信道进行定向快速连接，跳过扫描；租约有效时沿用缓存的IP，同时跳过DHCP
+// Directed fast connect with the cached BSSID and channel, skipping the scan; while the lease is valid the cached IP is
+// reused as well, skipping DHCP
+void beginWiFiFastConnect() {
+  wifiFastConnectActive = true;
+  wifiFastConnectAttempts++;
+  wifiUsingCachedIp = wifiLeaseValid();
+  if (wifiUsingCachedIp) {
+    WiFi.config(IPAddress(wifiCache.ip), IPAddress(wifiCache.gateway), IPAddress(wifiCache.subnet), IPAddress(wifiCache.dns));
+  } else {
+    LOG_I(LOG_WIFI_LEASE_UNKNOWN);
+    WiFi.config(0U, 0U, 0U);
+  }
+  WiFi.persistent(false); // BSSID和信道只用于本次连接 / BSSID and channel apply to this attempt only
+  WiFi.begin(WiFi.SSID(), WiFi.psk(), wifiCache.channel, wifiCache.bssid);
+  WiFi.persistent(true);
+  setWiFiState(WIFI_STATE_CONNECTING);
+}
+
+// 快速连接失败：作废缓存，回退到完整扫描和DHCP / Fast connect failed: drop the cache, fall back to a full scan and DHCP
+void fallBackFromFastConnect() {
+  invalidateWiFiCache();
+  WiFi.disconnect();
+  beginWiFiConnect();
+}
+
+// 向网关发送ARP请求 / Send an ARP request for the gateway
+void sendGatewayArp() {
+  struct netif* sta = stationNetif();
+  if (!sta) return;
+  ip4_addr_t gateway;
+  ip4_addr_set_u32(&gateway, wifiCache.gateway);
+  etharp_request(sta, &gateway);
+  wifiLinkCheckProbes++;
+}
+
+// 网关是否已回复ARP / Whether the gateway has answered the ARP request
+bool gatewayResolved() {
+  struct netif* sta = stationNetif();
+  if (!sta) return false;
+  ip4_addr_t gateway;
+  ip4_addr_set_u32(&gateway, wifiCache.gateway);
+  struct eth_addr* mac;
+  const ip4_addr_t* ip;
+  return etharp_find_addr(sta, &gateway, &mac, &ip) >= 0;
+}
+
+// 连接完成（含快速连接通过网关检查） / Connection complete (a fast connect has passed the gateway check)
+void onWiFiConnected() {
+  wifiConnectFailures = 0;
+  wifiTimeToConnect = millis() - wifiConnectStartTime;
+  wifiLastConnectWasFast = wifiFastConnectActive;
+  if (wifiFastConnectActive) wifiFastConnectSuccesses++;
+  setWiFiState(WIFI_STATE_CONNECTED);
+  markBootPhase(BOOT_PHASE_WIFI);
+  LOG_I(LOG_WIFI_CONNECTED, WiFi.localIP().toString(), wifiTimeToConnect);
+  saveWiFiCache();
+  startNetworkServices();
+}
+
+// 启动非阻塞配网门户 / Start the non-blocking configuration portal
+void startWiFiPortal() {
+  LOG_I(LOG_WIFI_PORTAL);
+  wifiUsingCachedIp = false;
+  server.stop(); // 配网门户占用80端口 / The portal takes over port 80
+  wifiManager.startConfigPortal("ESP8266_SmartConfig"); // 非阻塞模式下立即返回 / Returns immediately in non-blocking mode
+  setWiFiState(WIFI_STATE_PORTAL);
+}
+
+// 初始化WiFi连接（非阻塞） / Initialize WiFi connection (non-blocking)
 void initializeWiFi() {
     pinMode(LED_BUILTIN, OUTPUT); // 设置板载 LED 为输出模式 / Set onboard LED as output
     digitalWrite(LED_BUILTIN, HIGH); // 默认关闭 LED（高电平熄灭） / Default LED off (active LOW)
 
-    WiFiManager wifiManager;
-    wifiManager.setTimeout(180); // 设置智能配网超时时间为180秒 / Set smart configuration timeout to 180 seconds
+    WiFi.mode(WIFI_STA);
+    wifiManager.setConfigPortalBlocking(false); // 配网门户由 loop() 驱动 / The portal is driven by loop()
+    wifiManager.setConfigPortalTimeout(180); // 设置智能配网超时时间为180秒 / Set smart configuration timeout to 180 seconds
+
+    wifiConnectStartTime = millis();
+    if (WiFi.SSID().length() == 0) {
+        // 没有保存的凭据，直接进入配网模式 / No saved credentials, go straight to configuration mode
+        startWiFiPortal();
+    } else if (loadWiFiCache()) {
+        LOG_I(LOG_WIFI_FAST_CONNECT, WiFi.SSID(), wifiCache.channel);
+        beginWiFiFastConnect();
+    } else {
+        LOG_I(LOG_WIFI_CONNECTING, WiFi.SSID());
+        beginWiFiConnect();
+    }
+}
 
-    while (wifiConnectFailures < 3) {
-        if (wifiManager.autoConnect("ESP8266_SmartConfig")) { // 设置配网热点名称 / Set WiFi configuration hotspot name
-            Serial.println("WiFi连接成功 / WiFi connected");
-            Serial.print("设备IP地址: / Device IP Address: ");
-            Serial.println(WiFi.localIP());
-            return;
-        } else {
-            wifiConnectFailures++;
-            Serial.printf("WiFi连接失败，第%d次尝试 / WiFi connection failed, attempt %d\n", wifiConnectFailures, wifiConnectFailures);
-            delay(10000); // 每次失败后等待10秒 / Wait 10 seconds after each failure
-        }
+// 推进WiFi状态机，每次 loop() 调用 / Advance the WiFi state machine, called from every loop()
+void updateWiFi() {
+    unsigned long elapsed = millis() - wifiStateSince;
+
+    switch (wifiState) {
+        case WIFI_STATE_CONNECTING:
+            if (WiFi.status() == WL_CONNECTED) {
+                if (wifiUsingCachedIp) {
+                    // 关联成功不代表缓存的IP可用：先确认网关在同一网段并可达 / Joining the AP does not prove the cached IP works:
+                    // first confirm the gateway answers on this subnet
+                    wifiLinkCheckProbes = 0;
+                    sendGatewayArp();
+                    setWiFiState(WIFI_STATE_VERIFYING);
+                } else {
+                    onWiFiConnected();
+                }
+            } else if (wifiFastConnectActive && elapsed >= wifiFastConnectTimeout) {
+                // 快速连接失败不计入失败次数，立即回退到完整扫描和DHCP / A failed fast connect is not counted; fall back to a full scan and DHCP
+                LOG_W(LOG_WIFI_FAST_FAILED);
+                fallBackFromFastConnect();
+            } else if (elapsed >= wifiConnectTimeout) {
+                wifiConnectFailures++;
+                LOG_W(LOG_WIFI_CONNECT_FAILED, wifiConnectFailures);
+                setWiFiState(WIFI_STATE_BACKOFF);
+            }
+            break;
+
+        case WIFI_STATE_BACKOFF:
+            if (elapsed >= wifiRetryDelay) {
+                if (wifiConnectFailures >= wifiMaxFailures) {
+                    // 超过3次失败后重新进入智能配网模式 / Enter smart configuration mode after 3 failures
+                    LOG_W(LOG_WIFI_TOO_MANY_FAILURES);
+                    startWiFiPortal();
+                } else {
+                    beginWiFiConnect();
+                }
+            }
+            break;
+
+        case WIFI_STATE_VERIFYING:
+            if (WiFi.status() == WL_CONNECTED && gatewayResolved()) {
+                onWiFiConnected();
+            } else if (WiFi.status() != WL_CONNECTED || elapsed >= wifiLinkCheckTimeout) {
+                // 网关无应答：网段已变化或链路不通 / No answer from the gateway: the subnet changed or the link is down
+                LOG_W(LOG_WIFI_LINK_CHECK_FAILED);
+                fallBackFromFastConnect();
+            } else if (elapsed >= wifiLinkCheckProbes * wifiLinkCheckInterval) {
+                sendGatewayArp();
+            }
+            break;
+
+        case WIFI_STATE_PORTAL:
+            wifiManager.process(); // 处理配网门户请求 / Serve the configuration portal
+            if (!wifiManager.getConfigPortalActive()) {
+                // 门户已关闭（配网成功或超时），恢复网页服务并重新连接 / Portal closed (saved or timed out), restore web server and reconnect
+                server.begin();
+                wifiConnectFailures = 0;
+                if (WiFi.status() == WL_CONNECTED) {
+                    setWiFiState(WIFI_STATE_CONNECTING); // 下一轮进入已连接状态 / Becomes connected on the next pass
+                } else {
+                    beginWiFiConnect();
+                }
+            }
+            break;
+
+        case WIFI_STATE_CONNECTED:
+            if (WiFi.status() != WL_CONNECTED) {
+                // SDK会自动重连，重新计时等待 / The SDK reconnects on its own, restart the timeout
+                LOG_W(LOG_WIFI_LOST);
+                wifiConnectStartTime = millis();
+                setWiFiState(WIFI_STATE_CONNECTING);
+            } else if (wifiUsingCachedIp && !wifiLeaseValid()) {
+                // 租约过半，改用DHCP续租 / Half the lease has passed, switch to DHCP to renew
+                LOG_I(LOG_WIFI_LEASE_RENEW);
+                wifiUsingCachedIp = false;
+                WiFi.config(0U, 0U, 0U);
+            } else if (millis() - wifiCacheSavedAt >= wifiCacheRefreshInterval && WiFi.localIP().isSet()) {
+                saveWiFiCache(); // 刷新设备时钟和租约 / Refresh the device clock and the lease
+            }
+            break;
     }
+}
+
+// =============================
+// 控制接口准入控制 / Control route admission
+// =============================
+// 控制类接口按来源 IP 使用令牌桶限流，另有全局每秒预算；超出时在读取请求体之前直接回复 429，刷请求的脚本无法
+// 占满主循环。/api/motor 和 /api/batch 的命令也可能在表单或 CBOR 请求体中，这两个接口改由处理函数在解析请求体
+// 之后检查（请求体最多 1 KB）。停止电机的请求（/motor/off、command=off、含 off 的批量命令）始终放行，也不消耗令牌。
+// Control routes are rate limited with a token bucket per source IP plus a global per-second budget; over the limit
+// the request is answered 429 before its body is read, so a script flooding requests cannot take over the loop.
+// /api/motor and /api/batch may carry their commands in a form or CBOR body, so their handlers check once the body is
+// parsed (at most 1 KB). Requests that stop the motor (/motor/off, command=off, a batch containing off) are always
+// admitted and take no tokens.
+#ifndef RATE_LIMIT_PER_IP_RPS
+#define RATE_LIMIT_PER_IP_RPS 10 // 每个IP每秒补充的请求数 / Requests per second refilled per IP
+#endif
+#ifndef RATE_LIMIT_PER_IP_BURST
+#define RATE_LIMIT_PER_IP_BURST 20 // 每个IP可连续发出的请求数 / Back-to-back requests allowed per IP
+#endif
+#ifndef RATE_LIMIT_GLOBAL_RPS
+#define RATE_LIMIT_GLOBAL_RPS 40 // 所有IP合计每秒的请求数 / Requests per second across all IPs
+#endif
+#define RATE_LIMIT_CLIENTS 8 // 同时跟踪的IP数，满时替换最久未用的 / IPs tracked at once; the least recently used is replaced
+
+// 令牌以千分之一为单位，整数运算即可按毫秒补充 / Tokens are kept in thousandths so millisecond refills stay integral
+struct TokenBucket {
+  uint32_t ip;
+  uint32_t milliTokens;
+  unsigned long lastRefill;
+};
+
+TokenBucket rateBuckets[RATE_LIMIT_CLIENTS] = {}; // 每个IP的令牌桶 / Per-IP token buckets
+TokenBucket globalBucket = {0, RATE_LIMIT_GLOBAL_RPS * 1000UL, 0}; // 全局预算 / Global budget
+uint32_t rateLimitedPerIp = 0; // 因单个IP超限拒绝的请求 / Requests refused by a per-IP limit
+uint32_t rateLimitedGlobal = 0; // 因全局预算耗尽拒绝的请求 / Requests refused by the global budget
+uint32_t priorityAdmitted = 0; // 优先放行的停止请求 / Stop requests admitted with priority
+
+// 按经过的时间补充令牌，不超过 burst / Refill tokens for the elapsed time, up to burst
+void refillBucket(TokenBucket& bucket, uint32_t rps, uint32_t burst, unsigned long now) {
+  uint32_t capacity = burst * 1000;
+  unsigned long elapsed = now - bucket.lastRefill;
+  bucket.lastRefill = now;
+  if (elapsed >= capacity / rps) {
+    bucket.milliTokens = capacity;
+  } else {
+    bucket.milliTokens += elapsed * rps;
+    if (bucket.milliTokens > capacity) bucket.milliTokens = capacity;
+  }
+}
+
+// 查找IP的令牌桶，没有时替换最久未用的一项 / Find the IP's bucket, replacing the least recently used one if absent
+TokenBucket& bucketForIp(uint32_t ip, unsigned long now) {
+  TokenBucket* oldest = &rateBuckets[0];
+  for (TokenBucket& bucket : rateBuckets) {
+    if (bucket.ip == ip) return bucket;
+    if (now - bucket.lastRefill > now - oldest->lastRefill) oldest = &bucket;
+  }
+  oldest->ip = ip;
+  oldest->milliTokens = RATE_LIMIT_PER_IP_BURST * 1000UL;
+  oldest->lastRefill = now;
+  return *oldest;
+}
+
+bool isControlRoute(const char* uri) {
+  return strncmp(uri, "/motor/", 7) == 0 || strncmp(uri, "/api/motor", 10) == 0 || strncmp(uri, "/api/batch", 10) == 0 ||
+         strcmp(uri, "/api/step_once") == 0 || strcmp(uri, "/api/set_microstep") == 0 ||
+         strcmp(uri, "/api/set_motor_duration") == 0;
+}
+
+// 命令可能在请求体中、由处理函数检查准入的接口 / Routes whose command may be in the body; their handlers check admission
+bool isAdmittedAfterBody(const char* uri) {
+  return strncmp(uri, "/api/motor", 10) == 0 || strncmp(uri, "/api/batch", 10) == 0;
+}
+
+// 从当前来源IP和全局预算各扣一个令牌，不足时记录并返回 false / Take one token from the source IP and the global budget;
+// count and return false when either is empty
+bool chargeRequest() {
+  unsigned long now = millis();
+  TokenBucket& bucket = bucketForIp(server.remoteIP(), now);
+  refillBucket(bucket, RATE_LIMIT_PER_IP_RPS, RATE_LIMIT_PER_IP_BURST, now);
+  refillBucket(globalBucket, RATE_LIMIT_GLOBAL_RPS, RATE_LIMIT_GLOBAL_RPS, now);
+  if (bucket.milliTokens < 1000) {
+    rateLimitedPerIp++;
+    return false;
+  }
+  if (globalBucket.milliTokens < 1000) {
+    rateLimitedGlobal++;
+    return false;
+  }
+  bucket.milliTokens -= 1000;
+  globalBucket.milliTokens -= 1000;
+  return true;
+}
+
+// 准入检查，请求头解析后由网页服务器调用 / Admission check, called by the web server once the head is parsed
+bool admitRequest(HTTPMethod, const char* uri) {
+  if (!isControlRoute(uri) || isAdmittedAfterBody(uri)) return true;
+  if (strcmp(uri, "/motor/off") == 0) {
+    priorityAdmitted++;
+    return true;
+  }
+  return chargeRequest();
+}
 
-    // 超过3次失败后重新进入智能配网模式 / Enter smart configuration mode after 3 failures
-    Serial.println("WiFi连接失败超过3次，进入智能配网模式 / WiFi connection failed more than 3 times, entering smart configuration mode");
-    wifiManager.startConfigPortal("ESP8266_SmartConfig");
+// 请求体解析后的准入检查，由 /api/motor 和 /api/batch 的处理函数调用；拒绝时已回复 429
+// Admission check after the body is parsed, called by the /api/motor and /api/batch handlers; 429 is already sent
+// when it refuses
+bool admitParsedRequest(bool stop) {
+  if (stop) {
+    priorityAdmitted++;
+    return true;
+  }
+  if (chargeRequest()) return true;
+  sendTextMessage(429, MSG_TOO_MANY_REQUESTS);
+  return false;
 }
 
+// 路由表：编译期生成完美哈希，每个请求只需一次哈希查找 / Route table: perfect-hashed at compile time, one hash lookup per
+// request
+constexpr HttpRoute WEB_ROUTES[] = {
+  {"/", HTTP_ANY, handleRoot, nullptr},
+  {"/motor/on", HTTP_ANY, handleMotorOn, nullptr}, // 处理开启电机请求 / Handle motor on request
+  {"/motor/off", HTTP_ANY, handleMotorOff, nullptr}, //  处理关闭电机请求 / Handle motor off request
+  {"/motor/direction", HTTP_ANY, handleMotorDirection, nullptr}, // 处理切换电机方向请求 / Handle motor direction toggle request
+  {"/motor/speed_up", HTTP_ANY, handleSpeedUp, nullptr}, // 添加加速接口 / Add speed up endpoint
+  {"/motor/slow_down", HTTP_ANY, handleSlowDown, nullptr}, // 添加减速接口 / Add slow down endpoint
+  {"/api/motor", HTTP_ANY, handleMotorAPI, nullptr}, // 添加API接口处理 / Add API endpoint handling
+  {"/api/register", HTTP_ANY, handleRegisterController, nullptr}, // 添加注册控制端的API接口 / Add API endpoint for registering controllers
+  {"/api/version", HTTP_ANY, handleVersionInfo, nullptr}, // 添加获取版本信息的API接口 / Add API endpoint for getting version information
+  {"/ota", HTTP_ANY, handleOTA, nullptr}, // 添加OTA升级接口 / Add OTA upgrade endpoint
+  {"/ota/upload", HTTP_POST, []() {}, handleOTAUpload}, // OTA文件上传 / OTA file upload
+  {"/ota/remote", HTTP_POST, handleOTARemote, nullptr}, // 远程OTA升级 / Remote OTA upgrade
+  {"/api/mqtt_control", HTTP_ANY, handleToggleMQTTControl, nullptr}, // 添加MQTT控制开关接口 / Add MQTT control toggle endpoint
+  {"/api/device_info", HTTP_ANY, handleDeviceInfo, nullptr}, // 设备信息接口 / Device info API
+  {"/api/state", HTTP_GET, handleState, nullptr}, // 设备完整状态，支持 If-None-Match / Full device state with If-None-Match
+  {"/api/set_motor_duration", HTTP_ANY, handleSetMotorRunDuration, nullptr}, // 添加设置电机启动时长接口 / Add motor run duration API
+  {"/api/set_mqtt", HTTP_ANY, handleSetMQTTAddress, nullptr}, // 修复未注册的接口 / Fix unregistered endpoint
+  {"/clients", HTTP_ANY, handleClientsPage, nullptr}, // 控制端信息页面 / Client info page
+  {"/api/clients", HTTP_ANY, handleClientsList, nullptr}, // 控制端列表接口 / Client list API
+  {"/api/set_client_name", HTTP_ANY, handleSetClientName, nullptr}, // 设置控制端名称接口 / Set client name API
+  {"/api/reset_wifi", HTTP_ANY, handleResetWiFi, nullptr}, // 新增重新配网接口 / Add reset WiFi API
+  {"/api/set_microstep", HTTP_ANY, handleSetMicrostep, nullptr}, // 添加设置细分模式接口 / Add set microstep mode API
+  {"/api/get_microstep", HTTP_ANY, handleGetMicrostep, nullptr}, // 添加获取当前细分模式接口 / Add get current microstep mode API
+  {"/motor/step_once", HTTP_ANY, handleStepOnce, nullptr}, // 新增单步运行接口
+  {"/api/step_once", HTTP_ANY, handleApiStepOnce, nullptr}, // RESTful API接口
+  {"/api/metrics", HTTP_ANY, handleMetrics, nullptr}, // 运行指标接口 / Runtime metrics API
+  {"/api/boot_timing", HTTP_ANY, handleBootTiming, nullptr}, // 启动阶段耗时接口 / Boot phase timing API
+  {"/api/stalls", HTTP_ANY, handleStalls, nullptr}, // 卡顿记录接口 / Stall records API
+  {"/api/events", HTTP_GET, handleEvents, nullptr}, // 状态变化事件流（SSE） / State change event stream (SSE)
+  {"/api/batch", HTTP_POST, handleBatch, nullptr}, // 批量控制命令 / Batch control commands
+  // CBOR 版本，与 Accept: application/cbor 等效 / CBOR variants, same as sending Accept: application/cbor
+  {"/api/device_info.cbor", HTTP_ANY, handleDeviceInfo, nullptr},
+  {"/api/motor.cbor", HTTP_ANY, handleMotorAPI, nullptr},
+  {"/api/metrics.cbor", HTTP_ANY, handleMetrics, nullptr},
+  {"/api/batch.cbor", HTTP_POST, handleBatch, nullptr},
+#ifdef HTTP_SERVER_PROFILE
+  {"/api/route_stats", HTTP_ANY, handleRouteStats, nullptr}, // 路由耗时与堆占用统计 / Per-route time and heap statistics
+#endif
+};
+constexpr auto WEB_ROUTE_TABLE = makeHttpRouteTable(WEB_ROUTES);
+
 // 初始化Web服务器 / Initialize web server
 void setupWebServer() {
-  server.on("/", handleRoot);
-  server.on("/motor/on", handleMotorOn); // 处理开启电机请求 / Handle motor on request
-  server.on("/motor/off", handleMotorOff); //  处理关闭电机请求 / Handle motor off request
-  server.on("/motor/direction", handleMotorDirection); // 处理切换电机方向请求 / Handle motor direction toggle request
-  server.on("/motor/speed_up", handleSpeedUp); // 添加加速接口 / Add speed up endpoint
-  server.on("/motor/slow_down", handleSlowDown); // 添加减速接口 / Add slow down endpoint
-  server.on("/api/motor", handleMotorAPI); // 添加API接口处理 / Add API endpoint handling
-  server.on("/api/register", handleRegisterController); // 添加注册控制端的API接口 / Add API endpoint for registering controllers
-  server.on("/api/version", handleVersionInfo); // 添加获取版本信息的API接口 / Add API endpoint for getting version information
-  server.on("/ota", handleOTA); // 添加OTA升级接口 / Add OTA upgrade endpoint
-  server.on("/ota/upload", HTTP_POST, []() {}, handleOTAUpload); // OTA文件上传 / OTA file upload
-  server.on("/ota/remote", HTTP_POST, handleOTARemote); // 远程OTA升级 / Remote OTA upgrade
-  server.on("/api/mqtt_control", handleToggleMQTTControl); // 添加MQTT控制开关接口 / Add MQTT control toggle endpoint
-  server.on("/api/device_info", handleDeviceInfo); // 设备信息接口 / Device info API
-  server.on("/api/set_motor_duration", handleSetMotorRunDuration); // 添加设置电机启动时长接口 / Add motor run duration API
-  server.on("/api/set_mqtt", handleSetMQTTAddress); // 修复未注册的接口 / Fix unregistered endpoint
-  server.on("/clients", handleClientsPage); // 控制端信息页面 / Client info page
-  server.on("/api/set_client_name", handleSetClientName); // 设置控制端名称接口 / Set client name API
-  server.on("/api/reset_wifi", handleResetWiFi); // 新增重新配网接口 / Add reset WiFi API
-  server.on("/api/set_microstep", handleSetMicrostep); // 添加设置细分模式接口 / Add set microstep mode API
-  server.on("/api/get_microstep", handleGetMicrostep); // 添加获取当前细分模式接口 / Add get current microstep mode API
-  server.on("/motor/step_once", handleStepOnce); // 新增单步运行接口
-  server.on("/api/step_once", HTTP_ANY, handleApiStepOnce); // RESTful API接口
+  // 每个请求都视为活动，退出空闲模式 / Every request counts as activity and ends idle mode
+  server.addHook([](HTTPMethod, const char*) {
+    noteActivity();
+  });
+  server.setRoutes(WEB_ROUTE_TABLE);
+  server.setWakeFlag(&idleWakeRequested); // 新连接和新数据打断空闲休眠 / New connections and data cut idle sleep short
+  server.setAdmission(admitRequest); // 控制接口限流 / Rate limit control routes
+  // 网页资源用 If-None-Match 判断是否需要重新发送 / Web assets use If-None-Match to skip unchanged pages
+  // Accept 用于选择 JSON 或 CBOR / Accept selects JSON or CBOR
+  static const char* collectedHeaders[] = {"If-None-Match", "Accept"};
+  server.collectHeaders(collectedHeaders, 2);
   server.begin();
-  Serial.println("Web服务器已启动 / Web server started");
+  webSocket.begin();
+  webSocket.onEvent(onWebSocketEvent);
+  LOG_I(LOG_WEB_STARTED);
 }
 
 // 步进电机参数
 const int STEPS_PER_REV = 200; // 42步进电机一圈200步（1.8度/步）
 const int MOTOR_RPM = 60;      // 默认转速，可根据需要调整
 int pulsesPerRev = STEPS_PER_REV * 16; // 当前每圈脉冲数
+long motorPosition = 0; // 相对上电时的位置（脉冲数，正转为正） / Position relative to power-up (pulses, forward is positive)
 
 // 步进电机速度参数
 unsigned int stepInterval = 200; // 默认脉冲间隔（us），对应5kHz，适合细分
@@ -555,8 +1605,9 @@ enum MicrostepMode {
 // 当前细分模式，默认16细分
 int currentMicrostep = MICROSTEP_16;
 
-// 保存/加载细分模式
+// 保存/加载细分模式（未变化时不写EEPROM）
 void saveMicrostepMode(int microstep) {
+    if (EEPROM.read(MICROSTEP_MODE_EEPROM_ADDR) == microstep) return;
     EEPROM.write(MICROSTEP_MODE_EEPROM_ADDR, microstep);
     EEPROM.commit();
 }
@@ -585,20 +1636,26 @@ void updateStepIntervalRange() {
     if (stepInterval > stepIntervalMax) stepInterval = stepIntervalMax;
 }
 
-// 设置细分模式并重配置驱动
-void setMicrostepMode(int microstep) {
+// 按细分模式配置驱动，不写EEPROM；使能状态由 runStepper() 按 motorEnabled 控制
+void applyMicrostepMode(int microstep) {
     currentMicrostep = microstep;
     pulsesPerRev = STEPS_PER_REV * microstep;
     stepper.begin(MOTOR_RPM, microstep);
-    stepper.setEnableActiveState(LOW);
-    stepper.enable();
-    saveMicrostepMode(microstep); // 每次切换细分都保存
+    stepper.setEnableActiveState(LOW); // A4988 EN低电平有效
     updateStepIntervalRange(); // 动态调整脉冲间隔范围
-    Serial.printf("已切换细分模式: %d, 每圈脉冲数: %d, 最小脉冲间隔: %u us\n", microstep, pulsesPerRev, stepIntervalMin);
+    LOG_I(LOG_MICROSTEP_CHANGED, microstep, pulsesPerRev, stepIntervalMin);
+}
+
+// 设置细分模式并重配置驱动
+void setMicrostepMode(int microstep) {
+    applyMicrostepMode(microstep);
+    saveMicrostepMode(microstep); // 每次切换细分都保存
 }
 
 // 步进电机单步函数（兼容全步进和细分，脉冲宽度建议>2us，A4988推荐10-20us，过短可能全步进失效）
 void stepMotorOnce() {
+    markBootPhase(BOOT_PHASE_FIRST_STEP);
+    motorPosition += stepDir ? 1 : -1;
     digitalWrite(STEP_PIN, HIGH);
     delayMicroseconds(20); // 兼容全步进和细分，20us更安全
     digitalWrite(STEP_PIN, LOW);
@@ -610,6 +1667,7 @@ void stepMotorOnce() {
 void runStepper() {
     static unsigned long lastStepTime = 0;
     if (!motorEnabled) {
+        motorStepsRemaining = 0; // 任何方式停机都取消定长运行 / Any stop cancels a counted run
         stepper.disable();
         return;
     }
@@ -618,9 +1676,24 @@ void runStepper() {
     if (now - lastStepTime >= stepInterval) {
         lastStepTime = now;
         stepper.move(stepDir ? 1 : -1);
+        motorPosition += stepDir ? 1 : -1;
+        markBootPhase(BOOT_PHASE_FIRST_STEP);
+        if (motorStepsRemaining > 0 && --motorStepsRemaining == 0) {
+            motorEnabled = false;
+            digitalWrite(ENABLE_PIN, HIGH); // 停止电机 / Disable motor
+            LOG_I(LOG_MOTOR_RUN_DONE);
+        }
     }
 }
 
+// 输出当前脉冲间隔和转速 / Log the current step interval and speed
+void logMotorSpeed() {
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+    unsigned long centiRps = 100000000UL / ((unsigned long)stepInterval * pulsesPerRev); // 百分之一转/秒 / Hundredths of a revolution per second
+    LOG_I(LOG_SPEED_CHANGED, stepInterval, centiRps / 100, centiRps % 100);
+#endif
+}
+
 // 加速/减速接口（自动限制在当前细分允许的范围内）
 void adjustMotorSpeed(bool increase) {
     if (increase) {
@@ -630,68 +1703,372 @@ void adjustMotorSpeed(bool increase) {
         if (stepInterval < stepIntervalMax) stepInterval += 10;
         if (stepInterval > stepIntervalMax) stepInterval = stepIntervalMax;
     }
-    float rps = 1000000.0f / (stepInterval * pulsesPerRev);
-    Serial.printf("当前脉冲间隔: %u us, 约 %.2f 转/秒\n", stepInterval, rps);
-}
-
-// 网页端细分模式选择表单
-const char* MICROSTEP_OPTIONS_HTML = R"rawliteral(
-  <form id="microstepForm" style="margin:20px;">
-    <label>步进模式选择：</label>
-    <select id="microstepSelect">
-      <option value="1">全步进</option>
-      <option value="8">8细分</option>
-      <option value="16">16细分</option>
-      <option value="32">32细分</option>
-    </select>
-    <button type="button" onclick="setMicrostep()">切换模式</button>
-  </form>
-  <script>
-    function setMicrostep() {
-      var val = document.getElementById('microstepSelect').value;
-      fetch('/api/set_microstep?mode=' + val)
-        .then(response => {
-          if(response.ok) alert('细分模式已切换');
-          else alert('切换失败');
-        });
-    }
-    // 页面加载时设置当前选中
-    window.addEventListener('DOMContentLoaded', function() {
-      fetch('/api/get_microstep')
-        .then(r=>r.json()).then(d=>{
-          document.getElementById('microstepSelect').value = d.mode;
-        });
-    });
-  </script>
-)rawliteral";
+    logMotorSpeed();
+}
+
+// =============================
+// WebSocket实时控制与状态推送 / WebSocket real-time control and state push
+// =============================
+// 网页通过端口81的WebSocket发送控制帧，每帧一条短文本命令，省去每次按键建立一次HTTP连接：
+//   on / off / dir / fwd / rev / up / down / step / ms:<细分> / interval:<微秒> / run:<步数> / rate:<毫秒> / state
+// 设备在状态变化时向所有客户端广播状态JSON，两次推送至少间隔 wsPushIntervalMs；命令执行后立即推送，作为应答。
+// The page sends control frames over a WebSocket on port 81, one short text command per frame, instead of opening an
+// HTTP connection per button press:
+//   on / off / dir / fwd / rev / up / down / step / ms:<microstep> / interval:<us> / run:<steps> / rate:<ms> / state
+// The device broadcasts a state JSON to every client when the state changes, at most once per wsPushIntervalMs; a
+// command is answered by an immediate push.
+#define WS_PUSH_INTERVAL_DEFAULT_MS 200 // 默认推送间隔 / Default push interval
+#define WS_PUSH_INTERVAL_MIN_MS 50 // 最短推送间隔 / Shortest push interval
+#define WS_PUSH_INTERVAL_MAX_MS 5000 // 最长推送间隔 / Longest push interval
+#define WS_COMMAND_MAX_LENGTH 15 // 控制帧最大长度 / Max control frame length
+
+unsigned long wsPushIntervalMs = WS_PUSH_INTERVAL_DEFAULT_MS; // 推送间隔，可用 rate:<毫秒> 修改 / Push interval, set with rate:<ms>
+unsigned long wsLastPushTime = 0; // 上次推送时间 / Time of the last push
+bool wsPushRequested = false; // 新连接或命令后立即推送 / Push right away after a new connection or a command
+
+// 推送给网页的电机状态 / Motor state pushed to the page
+struct MotorState {
+  bool enabled;
+  bool forward;
+  unsigned int stepInterval;
+  long position;
+  int microstep;
+};
+MotorState wsLastState = {}; // 上次推送的状态 / State of the last push
+
+MotorState captureMotorState() {
+  return {motorEnabled, motorDirection, stepInterval, motorPosition, currentMicrostep};
+}
+
+bool sameMotorState(const MotorState& a, const MotorState& b) {
+  return a.enabled == b.enabled && a.forward == b.forward && a.stepInterval == b.stepInterval &&
+         a.position == b.position && a.microstep == b.microstep;
+}
+
+// 按间隔推送状态，没有客户端或状态未变化时不发送 / Push the state at the configured rate; skip when nobody listens or nothing changed
+void pushMotorState() {
+  if (webSocket.connectedClients() == 0) return;
+  unsigned long now = millis();
+  if (!wsPushRequested && now - wsLastPushTime < wsPushIntervalMs) return;
+  MotorState state = captureMotorState();
+  if (!wsPushRequested && sameMotorState(state, wsLastState)) return;
+  wsPushRequested = false;
+  wsLastPushTime = now;
+  wsLastState = state;
+
+  char frame[160];
+  int len = snprintf_P(frame, sizeof(frame),
+                       PSTR("{\"type\":\"state\",\"enabled\":%s,\"direction\":\"%s\",\"stepIntervalUs\":%u,"
+                            "\"pulsesPerRev\":%d,\"position\":%ld,\"microstep\":%d,\"rateMs\":%lu}"),
+                       state.enabled ? "true" : "false", state.forward ? "forward" : "reverse", state.stepInterval,
+                       pulsesPerRev, state.position, state.microstep, wsPushIntervalMs);
+  webSocket.broadcastTXT(frame, len);
+}
+
+// 控制命令：WebSocket 控制帧和 POST /api/batch 共用同一套短文本命令，先解析校验，再执行
+// Control commands: WebSocket frames and POST /api/batch share one set of short text commands, parsed and validated
+// first, then applied
+enum ControlOp : uint8_t {
+  CMD_ON,        // on
+  CMD_OFF,       // off
+  CMD_DIR,       // dir：切换方向 / toggle direction
+  CMD_FORWARD,   // fwd
+  CMD_REVERSE,   // rev
+  CMD_UP,        // up：加速一档 / one speed step up
+  CMD_DOWN,      // down：减速一档 / one speed step down
+  CMD_STEP,      // step：单步 / single step
+  CMD_MICROSTEP, // ms:<细分> / ms:<microstep>
+  CMD_INTERVAL,  // interval:<微秒>，按当前细分限制范围 / interval:<us>, clamped to the current microstep's range
+  CMD_RUN,       // run:<步数>：开启电机，走完后自动停止 / run:<steps>: enable the motor, stop after that many steps
+  CMD_RATE,      // rate:<毫秒>：WebSocket推送间隔 / rate:<ms>: WebSocket push interval
+  CMD_STATE,     // state：只请求状态 / state: just ask for the state
+};
+
+struct ControlCommand {
+  ControlOp op;
+  long value;
+};
+
+// 解析并校验一条命令，不改变任何状态 / Parse and validate one command without changing any state
+bool parseControlCommand(const char* cmd, size_t len, ControlCommand& out) {
+  const char* colon = (const char*)memchr(cmd, ':', len);
+  size_t nameLen = colon ? colon - cmd : len;
+  long value = 0;
+  if (colon) {
+    size_t digits = len - nameLen - 1;
+    if (digits == 0 || digits > 9) return false;
+    for (size_t i = 0; i < digits; i++) {
+      if (!isdigit((unsigned char)colon[1 + i])) return false;
+      value = value * 10 + (colon[1 + i] - '0');
+    }
+  }
+  auto is = [&](PGM_P name) { return strlen_P(name) == nameLen && strncmp_P(cmd, name, nameLen) == 0; };
+  out.value = value;
+  if (!colon) {
+    if (is(PSTR("on"))) out.op = CMD_ON;
+    else if (is(PSTR("off"))) out.op = CMD_OFF;
+    else if (is(PSTR("dir"))) out.op = CMD_DIR;
+    else if (is(PSTR("fwd"))) out.op = CMD_FORWARD;
+    else if (is(PSTR("rev"))) out.op = CMD_REVERSE;
+    else if (is(PSTR("up"))) out.op = CMD_UP;
+    else if (is(PSTR("down"))) out.op = CMD_DOWN;
+    else if (is(PSTR("step"))) out.op = CMD_STEP;
+    else if (is(PSTR("state"))) out.op = CMD_STATE;
+    else return false;
+    return true;
+  }
+  if (is(PSTR("ms"))) {
+    out.op = CMD_MICROSTEP;
+    return value == MICROSTEP_FULL || value == MICROSTEP_8 || value == MICROSTEP_16 || value == MICROSTEP_32;
+  }
+  if (is(PSTR("interval"))) {
+    out.op = CMD_INTERVAL;
+    return value > 0 && value <= (long)stepIntervalMax;
+  }
+  if (is(PSTR("run"))) {
+    out.op = CMD_RUN;
+    return value > 0;
+  }
+  if (is(PSTR("rate"))) {
+    out.op = CMD_RATE;
+    return value >= WS_PUSH_INTERVAL_MIN_MS && value <= WS_PUSH_INTERVAL_MAX_MS;
+  }
+  return false;
+}
+
+// 设置电机方向 / Set the motor direction
+void setMotorDirectionFromCommand(bool forward) {
+  motorDirection = forward;
+  stepDir = motorDirection;
+  digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 设置电机方向 / Set motor direction
+  if (motorDirection) {
+    LOG_I(LOG_DIRECTION_FORWARD_CMD);
+  } else {
+    LOG_I(LOG_DIRECTION_REVERSE_CMD);
+  }
+}
+
+// 执行一条已校验的命令 / Apply one validated command
+void applyControlCommand(const ControlCommand& command) {
+  switch (command.op) {
+    case CMD_ON:
+      if (!motorEnabled) {
+        motorEnabled = true;
+        motorStartTime = millis(); // 记录启动时间 / Record start time
+        digitalWrite(ENABLE_PIN, LOW); // 启动电机 / Enable motor
+        LOG_I(LOG_MOTOR_ON_CMD);
+      }
+      updateMotorActivity(); // 更新电机活动时间戳 / Update motor activity timestamp
+      break;
+    case CMD_OFF:
+      if (motorEnabled) {
+        motorEnabled = false;
+        digitalWrite(ENABLE_PIN, HIGH); // 禁用电机 / Disable motor
+        LOG_I(LOG_MOTOR_OFF_CMD);
+      }
+      break;
+    case CMD_DIR:
+      setMotorDirectionFromCommand(!motorDirection);
+      break;
+    case CMD_FORWARD:
+      setMotorDirectionFromCommand(true);
+      break;
+    case CMD_REVERSE:
+      setMotorDirectionFromCommand(false);
+      break;
+    case CMD_UP:
+      adjustMotorSpeed(true); // 加速 / Increase speed
+      break;
+    case CMD_DOWN:
+      adjustMotorSpeed(false); // 减速 / Decrease speed
+      break;
+    case CMD_STEP:
+      stepMotorOnce();
+      break;
+    case CMD_MICROSTEP:
+      setMicrostepMode(command.value);
+      break;
+    case CMD_INTERVAL:
+      stepInterval = command.value;
+      updateStepIntervalRange(); // 限制在当前细分允许的范围内 / Clamp to the current microstep's range
+      logMotorSpeed();
+      break;
+    case CMD_RUN:
+      motorEnabled = true;
+      motorStartTime = millis(); // 运行时长限制仍然有效 / The run duration limit still applies
+      motorStepsRemaining = command.value;
+      digitalWrite(ENABLE_PIN, LOW); // 启动电机 / Enable motor
+      updateMotorActivity();
+      LOG_I(LOG_MOTOR_RUN_CMD, motorStepsRemaining);
+      break;
+    case CMD_RATE:
+      wsPushIntervalMs = command.value;
+      break;
+    case CMD_STATE:
+      break;
+  }
+  wsPushRequested = true; // 推送新状态 / Push the new state
+}
+
+// 执行一条控制帧，返回是否识别 / Execute one control frame, returns whether it was recognised
+bool handleWebSocketCommand(const char* cmd) {
+  LOG_D(LOG_WS_COMMAND, cmd);
+  ControlCommand command;
+  if (!parseControlCommand(cmd, strlen(cmd), command)) return false;
+  applyControlCommand(command); // 推送新状态作为应答 / The state push is the answer
+  return true;
+}
+
+// 处理WebSocket事件 / Handle WebSocket events
+void onWebSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+  stallMark(STALL_WEB);
+  idleWakeRequested = true; // 任何WebSocket事件都结束空闲休眠 / Any WebSocket event ends the idle sleep
+  switch (type) {
+    case WStype_CONNECTED:
+      noteActivity();
+      wsPushRequested = true; // 新连接先收到一次完整状态 / A new connection gets the full state first
+      LOG_I(LOG_WS_CONNECTED, num);
+      break;
+    case WStype_DISCONNECTED:
+      LOG_I(LOG_WS_DISCONNECTED, num);
+      break;
+    case WStype_TEXT: {
+      noteActivity();
+      char cmd[WS_COMMAND_MAX_LENGTH + 1];
+      bool ok = length <= WS_COMMAND_MAX_LENGTH;
+      if (ok) {
+        memcpy(cmd, payload, length);
+        cmd[length] = '\0';
+        ok = handleWebSocketCommand(cmd);
+      }
+      if (!ok) {
+        webSocket.sendTXT(num, "{\"type\":\"error\"}");
+        LOG_W(LOG_WS_UNKNOWN_COMMAND);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// =============================
+// Server-Sent Events 状态流 / Server-Sent Events state stream
+// =============================
+// GET /api/events 保持连接不关闭，电机开关、方向、脉冲间隔、细分模式或控制端登记表变化时发送一条 state 事件。
+// 每次变化序号加一，写在事件的 id 字段和数据的 seq 字段中，订阅者可据此发现漏掉的事件；订阅者发送缓冲区
+// 已满时本次事件跳过，不阻塞主循环。新订阅先收到一条当前状态（序号不变）。
+// GET /api/events keeps the connection open and sends a state event whenever the motor on/off state, direction, step
+// interval, microstep mode or the client registry changes. The sequence number goes up by one per change and is sent
+// in the event id and in the seq field, so a subscriber can spot missed events; when a subscriber's send buffer is
+// full the event is skipped for it rather than blocking the loop. A new subscriber first gets the current state (same
+// sequence number).
+#define SSE_MAX_CLIENTS 4 // 最大订阅数 / Max subscribers
+#define SSE_KEEPALIVE_MS 15000 // 心跳注释间隔，用于发现断开的订阅 / Keepalive comment interval, detects dropped subscribers
+
+int sseStreams[SSE_MAX_CLIENTS]; // 订阅连接的流ID / Stream ids of the subscriber connections
+bool sseActive[SSE_MAX_CLIENTS] = {false}; // 槽位是否在用 / Whether each slot is in use
+unsigned long sseSequence = 0; // 事件序号 / Event sequence number
+unsigned long sseLastKeepalive = 0; // 上次心跳时间 / Time of the last keepalive
+
+// 触发事件的状态 / State that triggers events
+struct EventState {
+  bool enabled;
+  bool forward;
+  unsigned int stepInterval;
+  int microstep;
+  unsigned long clientsVersion;
+};
+EventState sseLastState = {};
+
+EventState captureEventState() {
+  return {motorEnabled, motorDirection, stepInterval, currentMicrostep, clientsVersion};
+}
+
+bool sameEventState(const EventState& a, const EventState& b) {
+  return a.enabled == b.enabled && a.forward == b.forward && a.stepInterval == b.stepInterval &&
+         a.microstep == b.microstep && a.clientsVersion == b.clientsVersion;
+}
+
+// 格式化一条 state 事件 / Format one state event
+int formatStateEvent(char* buf, size_t size, const EventState& state) {
+  return snprintf_P(buf, size,
+                    PSTR("id: %lu\nevent: state\ndata: {\"seq\":%lu,\"enabled\":%s,\"direction\":\"%s\","
+                         "\"stepIntervalUs\":%u,\"microstep\":%d,\"onlineClients\":%u}\n\n"),
+                    sseSequence, sseSequence, state.enabled ? "true" : "false", state.forward ? "forward" : "reverse",
+                    state.stepInterval, state.microstep, (unsigned)clients.size());
+}
+
+// 处理SSE订阅请求：接管当前连接并写入响应头 / Handle SSE subscription: take over the connection and write the headers
+void handleEvents() {
+  int slot = -1;
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (!sseActive[i]) {
+      slot = i;
+      break;
+    }
+  }
+  if (slot < 0) {
+    sendTextMessage(503, MSG_TOO_MANY_SUBSCRIBERS);
+    LOG_W(LOG_SSE_REJECTED);
+    return;
+  }
+  int stream = server.takeStream(PSTR("HTTP/1.1 200 OK\r\n"
+                                     "Content-Type: text/event-stream\r\n"
+                                     "Cache-Control: no-cache\r\n"
+                                     "Connection: keep-alive\r\n"
+                                     "Access-Control-Allow-Origin: *\r\n\r\n"));
+  if (stream < 0) return;
+  char event[192];
+  int len = formatStateEvent(event, sizeof(event), captureEventState());
+  server.streamWrite(stream, event, len);
+  sseStreams[slot] = stream;
+  sseActive[slot] = true;
+  LOG_I(LOG_SSE_SUBSCRIBED, slot);
+}
+
+// 检测状态变化并发送事件，释放已断开的订阅 / Detect state changes, send events and release closed subscribers
+void pollServerSentEvents() {
+  EventState state = captureEventState();
+  bool changed = !sameEventState(state, sseLastState);
+  if (changed) {
+    sseLastState = state;
+    sseSequence++;
+  }
+
+  unsigned long now = millis();
+  bool keepalive = now - sseLastKeepalive >= SSE_KEEPALIVE_MS;
+  if (keepalive) sseLastKeepalive = now;
+
+  char event[192];
+  int len = -1; // 有订阅且状态变化时才格式化 / Formatted only when needed
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (!sseActive[i]) continue;
+    if (!server.streamConnected(sseStreams[i])) {
+      server.streamClose(sseStreams[i]); // 释放连接 / Release the connection
+      sseActive[i] = false;
+      LOG_I(LOG_SSE_CLOSED, i);
+      continue;
+    }
+    if (changed) {
+      if (len < 0) len = formatStateEvent(event, sizeof(event), state);
+      server.streamWrite(sseStreams[i], event, len); // 发送缓冲区不足时跳过 / Skipped when the send buffer lacks room
+    } else if (keepalive) {
+      server.streamWrite(sseStreams[i], ":\n\n", 3); // SSE注释行，浏览器会忽略 / SSE comment line, ignored by browsers
+    }
+  }
+}
 
 // 初始化函数 / Initialization function
+// 各子系统按依赖顺序只初始化一次：引脚 -> EEPROM -> 步进驱动 -> Web -> WiFi（之后由 loop() 推进 MQTT/OTA）
+// Each subsystem is initialized exactly once, in dependency order: pins -> EEPROM -> stepper -> web -> WiFi (MQTT/OTA follow from loop())
 void setup() {
-    EEPROM.begin(EEPROM_SIZE);
-    Serial.begin(115200);
-    Serial.println("ESP8266 步进电机控制系统启动");
-    Serial.printf("请确保A4988的MS1/MS2/MS3全部为高电平，已设置为16细分，脉冲/圈=%d\n", pulsesPerRev);
-    pinMode(DIR_PIN, OUTPUT);
-    pinMode(STEP_PIN, OUTPUT);
-    pinMode(ENABLE_PIN, OUTPUT);
-    digitalWrite(ENABLE_PIN, HIGH); // 默认关闭电机
-    pinMode(MOTOR_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(BUTTON_DIRECTION_PIN, INPUT_PULLUP);
-
-    // 加载细分模式并初始化驱动（确保调用）
-    currentMicrostep = loadMicrostepMode();
-    setMicrostepMode(currentMicrostep);
-
-    // ...existing code...
-    stepper.begin(MOTOR_RPM, currentMicrostep);
-    stepper.setEnableActiveState(LOW); // A4988 EN低电平有效
-    stepper.enable();
-    currentMicrostep = loadMicrostepMode();
-    setMicrostepMode(currentMicrostep);
+   Serial.begin(115200);
    // 打印版本信息 / Print version information
-   Serial.println("ESP8266 步进电机远程控制系统 / ESP8266 Stepper Motor Remote Control System");
-   Serial.println("固件版本: " FIRMWARE_VERSION " / Firmware Version: " FIRMWARE_VERSION);
+   LOG_I(LOG_BOOT_BANNER);
+   LOG_I(LOG_FIRMWARE_VERSION, FIRMWARE_VERSION);
 
+   // 初始化电机引脚 / Initialize motor pins
    pinMode(DIR_PIN, OUTPUT);
    pinMode(STEP_PIN, OUTPUT);
    pinMode(ENABLE_PIN, OUTPUT);
@@ -699,69 +2076,110 @@ void setup() {
 
    // 初始化物理按钮引脚 / Initialize physical button pins
    pinMode(MOTOR_BUTTON_PIN, INPUT_PULLUP); // 初始化电机按钮引脚 / Initialize motor button pin
-   Serial.println("电机按钮初始化完成 / Motor button initialized");
-
    pinMode(BUTTON_DIRECTION_PIN, INPUT_PULLUP); // 使用内部上拉电阻 / Use internal pull-up resistor
-   Serial.println("物理按钮初始化完成 / Physical buttons initialized");
 
-   // 初始化WiFi连接 / Initialize WiFi connection
-   initializeWiFi();
+   // 按钮中断用于从空闲模式立即唤醒 / Button interrupts wake the loop out of idle mode immediately
+   attachInterrupt(digitalPinToInterrupt(MOTOR_BUTTON_PIN), onButtonInterrupt, CHANGE);
+   attachInterrupt(digitalPinToInterrupt(BUTTON_DIRECTION_PIN), onButtonInterrupt, CHANGE);
+   lastActivityTime = millis();
+   markBootPhase(BOOT_PHASE_PINS);
+   LOG_I(LOG_BUTTONS_READY);
 
-   // 加载保存的MQTT地址
+   // 加载EEPROM中保存的配置 / Load settings saved in EEPROM
+   EEPROM.begin(EEPROM_SIZE);
+   int savedMicrostep = loadMicrostepMode();
    loadMQTTAddress(); // 加载保存的MQTT地址
-   client.setServer(mqtt_server, 1883); // 设置MQTT服务器地址
+   markBootPhase(BOOT_PHASE_EEPROM);
+
+   // 初始化步进驱动（加载的配置无需回写EEPROM） / Configure the stepper driver (loaded settings need no write-back)
+   applyMicrostepMode(savedMicrostep);
+   markBootPhase(BOOT_PHASE_STEPPER);
+   LOG_I(LOG_STEPPER_READY, pulsesPerRev);
 
    // 初始化MQTT / Initialize MQTT
+   client.setServer(mqtt_server, 1883); // 设置MQTT服务器地址
    client.setCallback(mqttCallback); // 设置MQTT回调函数 / Set MQTT callback function
+   client.setSocketTimeout(MQTT_CONNACK_TIMEOUT_S);
+   espClient.setTimeout(MQTT_TCP_CONNECT_TIMEOUT_MS); // 限制TCP连接的阻塞时间 / Bound the blocking TCP connect
 
    // 初始化Web服务器 / Initialize web server
+   beginStateEpoch();
    setupWebServer();
+   markBootPhase(BOOT_PHASE_WEB);
+
+   // 初始化WiFi连接（非阻塞，由 loop() 推进） / Initialize WiFi connection (non-blocking, advanced by loop())
+   initializeWiFi();
 
    // 初始化OTA / Initialize OTA
    ArduinoOTA.onStart([]() {
-     String type = ArduinoOTA.getCommand() == U_FLASH ? "sketch" : "filesystem";
-     Serial.println("开始OTA更新: " + type + " / Starting OTA update: " + type);
+     LOG_I(LOG_OTA_START, ArduinoOTA.getCommand() == U_FLASH ? "sketch" : "filesystem");
    });
    ArduinoOTA.onEnd([]() {
-     Serial.println("\nOTA更新完成 / OTA update completed");
+     LOG_I(LOG_OTA_END);
+     logFlush(); // 设备即将重启 / The device restarts next
    });
    ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
-     // 修复格式化字符串问题 / Fix format string issue
-     Serial.printf("OTA更新进度: %u%%\r / OTA update progress: %u%%\r", progress * 100 / total, progress * 100 / total);
+     // 只在每10%记录一次，避免塞满日志缓冲区 / Log every 10% only so the ring is not flooded
+     static unsigned int lastLoggedPercent = 0;
+     unsigned int percent = progress * 100 / total;
+     if (percent / 10 != lastLoggedPercent / 10) {
+       lastLoggedPercent = percent;
+       LOG_D(LOG_OTA_PROGRESS, percent);
+     }
    });
    ArduinoOTA.onError([](ota_error_t error) {
-     // 修复格式化字符串问题 / Fix format string issue
-     Serial.printf("OTA更新错误[%u]: / OTA update error [%u]: ", static_cast<unsigned int>(error), static_cast<unsigned int>(error));
      if (error == OTA_AUTH_ERROR) {
-       Serial.println("认证失败 / Authentication failed");
+       LOG_E(LOG_OTA_ERROR_AUTH);
      } else if (error == OTA_BEGIN_ERROR) {
-       Serial.println("开始失败 / Begin failed");
+       LOG_E(LOG_OTA_ERROR_BEGIN);
      } else if (error == OTA_CONNECT_ERROR) {
-       Serial.println("连接失败 / Connection failed");
+       LOG_E(LOG_OTA_ERROR_CONNECT);
      } else if (error == OTA_RECEIVE_ERROR) {
-       Serial.println("接收失败 / Receive failed");
+       LOG_E(LOG_OTA_ERROR_RECEIVE);
      } else if (error == OTA_END_ERROR) {
-       Serial.println("结束失败 / End failed");
+       LOG_E(LOG_OTA_ERROR_END);
+     } else {
+       LOG_E(LOG_OTA_ERROR, static_cast<unsigned int>(error));
      }
    }); // 修复结束符号 / Fix closing brace
-   ArduinoOTA.begin();
-   Serial.println("OTA功能已启动 / OTA functionality started");
+   // ArduinoOTA.begin() 在首次联网后由 startNetworkServices() 调用 / ArduinoOTA.begin() is called by startNetworkServices() once the network is up
+
+   // 启动主循环卡顿检测 / Start the loop stall watchdog
+   initializeStallWatchdog();
+}
+
+// 首次联网后启动OTA等服务 / Start OTA and other services after the first connection
+void startNetworkServices() {
+  if (networkServicesStarted) return;
+  networkServicesStarted = true;
+  ArduinoOTA.begin();
+  markBootPhase(BOOT_PHASE_OTA);
+  LOG_I(LOG_OTA_STARTED);
 }
 
 // 主循环 / Main loop
 void loop() {
+  unsigned long loopStart = micros();
+  stallPassBegin(); // 卡顿检测：本轮开始 / Stall watchdog: pass begins
+
+  stallMark(STALL_WIFI);
+  updateWiFi(); // 推进WiFi连接状态机 / Advance the WiFi state machine
+  stallMark(STALL_CONTROL);
   updateLEDState(); // 更新 LED 状态 / Update LED state
   handleMotorButton(); // 处理电机按钮逻辑 / Handle motor button logic
   handleMotorRunDuration(); // 处理电机运行时长逻辑 / Handle motor run duration logic
   checkMotorInactivity(); // 检查电机未使用超时 / Check motor inactivity timeout
 
   // 更新电机步进脉冲信号 / Update motor step pulse signal
+  stallMark(STALL_STEPPER);
   runStepper();
 
   // 检查物理按钮状态 / Check physical button states
+  stallMark(STALL_BUTTONS);
   handlePhysicalButtons();
 
   // 检查MQTT连接状态，仅在启用时检测 / Check MQTT connection status only when enabled
+  stallMark(STALL_MQTT);
   if (mqttControlEnabled) {
     if (!client.connected()) {
       reconnectMQTT(); // 尝试重新连接MQTT / Attempt to reconnect to MQTT
@@ -771,58 +2189,85 @@ void loop() {
     // 如果禁用MQTT控制，确保不会尝试连接或处理消息 / Ensure no connection or message handling when disabled
     static bool mqttDisabledLogged = false;
     if (!mqttDisabledLogged) {
-      Serial.println("MQTT控制已禁用，跳过MQTT检测 / MQTT control disabled, skipping MQTT checks");
+      LOG_D(LOG_MQTT_CHECKS_DISABLED);
       mqttDisabledLogged = true;
     }
   }
 
+  stallMark(STALL_WEB);
   server.handleClient(); // 处理网页请求 / Handle web requests
-  ArduinoOTA.handle(); // 处理OTA更新 / Handle OTA updates
+  webSocket.loop(); // 处理WebSocket帧 / Handle WebSocket frames
+  pushMotorState(); // 按推送间隔广播状态变化 / Broadcast state changes at the push rate
+  pollServerSentEvents(); // 状态变化时向SSE订阅者发送事件 / Send SSE events on state changes
+  publishTelemetry(); // 状态变化时发布MQTT遥测 / Publish MQTT telemetry on state changes
+  updateStateGeneration(); // 状态变化时增加 /api/state 的代数 / Bump the /api/state generation on state changes
+  if (networkServicesStarted) {
+    stallMark(STALL_OTA);
+    ArduinoOTA.handle(); // 处理OTA更新 / Handle OTA updates
+  }
+
+  stallMark(STALL_LOG);
+  logDrain(); // 所有子系统处理完后输出日志（非阻塞） / Drain logs after every subsystem ran (non-blocking)
+  stallPassEnd(); // 卡顿检测：本轮结束，空闲休眠不计入 / Stall watchdog: pass ends, idle sleep is not counted
+
+  unsigned long loopWork = micros() - loopStart;
+  loopCount++;
+  loopWorkMicros += loopWork;
+  if (loopWork > loopWorkMaxMicros) loopWorkMaxMicros = loopWork;
+
+  idleThrottle(); // 空闲时有界休眠 / Bounded sleep while idle
 }
 
 // 处理加速请求 / Handle speed up request
 void handleSpeedUp() {
   adjustMotorSpeed(true); // 加速 / Increase speed
-  server.send(200, "text/plain; charset=utf-8", "电机加速 / Motor speed increased");
+  sendTextMessage(200, MSG_SPEED_UP);
 }
 
 // 处理减速请求 / Handle slow down request
 void handleSlowDown() {
   adjustMotorSpeed(false); // 减速 / Decrease speed
-  server.send(200, "text/plain; charset=utf-8", "电机减速 / Motor speed decreased");
+  sendTextMessage(200, MSG_SLOW_DOWN);
 }
 
 // 合并重复的 mqttCallback 函数定义 / Merge duplicate mqttCallback definitions
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
+    noteActivity(); // MQTT消息视为活动 / An MQTT message counts as activity
     if (!mqttControlEnabled) {
-        Serial.printf("[%lu] MQTT控制已禁用，忽略消息 / MQTT control disabled, ignoring message\n", millis());
+        LOG_D(LOG_MQTT_MESSAGE_IGNORED);
         return;
     }
     String message;
-    for (unsigned int i = 0; i < length; i++) {
-        message += (char)payload[i];
+    char command[32];
+    if (isCborContainer(payload, length)) {
+        // CBOR负载：{"command": "..."} / CBOR payload: {"command": "..."}
+        if (cborMapLookup(payload, length, PSTR("command"), command, sizeof(command))) message = command;
+    } else {
+        for (unsigned int i = 0; i < length; i++) {
+            message += (char)payload[i];
+        }
     }
-    Serial.printf("收到 MQTT 消息，主题: %s，内容: %s\n", topic, message.c_str());
+    LOG_D(LOG_MQTT_MESSAGE, topic, message);
 
     // 处理电机控制主题的消息 / Handle motor control topic messages
     if (String(topic) == mqtt_topic_motor_control) {
         if (message == "forward") {
             digitalWrite(DIR_PIN, HIGH); // 设置为正向运动 / Set to forward
             digitalWrite(ENABLE_PIN, LOW); // 启动电机 / Enable motor
-            Serial.println("电机正向运动（通过 MQTT） / Motor moving forward (via MQTT)");
+            LOG_I(LOG_MQTT_FORWARD);
         } else if (message == "reverse") {
             digitalWrite(DIR_PIN, LOW); // 设置为反向运动 / Set to reverse
             digitalWrite(ENABLE_PIN, LOW); // 启动电机 / Enable motor
-            Serial.println("电机反向运动（通过 MQTT） / Motor moving reverse (via MQTT)");
+            LOG_I(LOG_MQTT_REVERSE);
         } else if (message == "off") {
             digitalWrite(ENABLE_PIN, HIGH); // 停止电机 / Disable motor
-            Serial.println("电机停止（通过 MQTT） / Motor stopped (via MQTT)");
+            LOG_I(LOG_MQTT_STOP);
         }
     } else if (String(topic) == "motor/step_once") {
         stepMotorOnce();
-        Serial.println("收到MQTT单步运行指令 / Step motor once by MQTT");
+        LOG_I(LOG_MQTT_STEP_ONCE);
     } else {
-        Serial.printf("未处理的 MQTT 主题: %s\n", topic);
+        LOG_W(LOG_MQTT_UNHANDLED_TOPIC, topic);
     }
 }
 
@@ -835,7 +2280,11 @@ void handlePhysicalButtons() {
       motorDirection = !motorDirection; // 切换电机方向 / Toggle motor direction
       stepDir = motorDirection;
       digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 控制电机方向引脚 / Control motor direction pin
-      Serial.printf("[%lu] 电机方向已切换为: %s（通过按钮） / Motor direction toggled to: %s (via button)\n", millis(), motorDirection ? "正转 / Forward" : "反转 / Reverse", motorDirection ? "正转 / Forward" : "反转 / Reverse");
+      if (motorDirection) {
+        LOG_I(LOG_DIRECTION_FORWARD_BUTTON);
+      } else {
+        LOG_I(LOG_DIRECTION_REVERSE_BUTTON);
+      }
     }
     lastDebounceTime = millis(); // 更新防抖时间戳 / Update debounce timestamp
   }
@@ -847,7 +2296,7 @@ void startMotor() {
   if (motorEnabled) {
     motorStartTime = millis(); // 记录启动时间 / Record start time
     digitalWrite(ENABLE_PIN, LOW); // 启动电机 / Enable motor
-    Serial.printf("[%lu] 电机启动 / Motor started\n", getTimestamp());
+    LOG_I(LOG_MOTOR_STARTED);
   }
 }
 
@@ -871,22 +2320,24 @@ void handleMotorButton() {
                 if (currentDirectionButtonState == HIGH) {
                     motorEnabled = false;
                     digitalWrite(ENABLE_PIN, HIGH); // 禁用电机 / Disable motor
-                    Serial.printf("[%lu] 电机已关闭（通过按钮） / Motor disabled (via button)\n", millis());
+                    LOG_I(LOG_MOTOR_OFF_BUTTON);
                 } else {
                     // 限位触发，准备反转运行 / Limit triggered, prepare for reverse
                     motorDirection = !motorDirection; // 切换电机方向 / Toggle motor direction
                     stepDir = motorDirection;
                     digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 设置方向引脚 / Set direction pin
-                    Serial.printf("[%lu] 限位触发，电机方向已切换为: %s / Limit triggered, motor direction toggled to: %s\n",
-                                  millis(), motorDirection ? "正转 / Forward" : "反转 / Reverse",
-                                  motorDirection ? "正转 / Forward" : "反转 / Reverse");
+                    if (motorDirection) {
+                        LOG_I(LOG_LIMIT_FORWARD);
+                    } else {
+                        LOG_I(LOG_LIMIT_REVERSE);
+                    }
                 }
             } else {
                 // 如果电机关闭，启动电机 / If motor is disabled, enable the motor
                 motorEnabled = true;
                 motorStartTime = millis(); // 记录启动时间 / Record start time
                 digitalWrite(ENABLE_PIN, LOW); // 启动电机 / Enable motor
-                Serial.printf("[%lu] 电机已开启（通过按钮） / Motor enabled (via button)\n", millis());
+                LOG_I(LOG_MOTOR_ON_BUTTON);
             }
         }
     }
@@ -900,46 +2351,714 @@ void handleMotorRunDuration() {
   if (motorEnabled && (millis() - motorStartTime >= motorRunDuration)) {
     motorEnabled = false;
     digitalWrite(ENABLE_PIN, HIGH); // 停止电机 / Disable motor
-    Serial.printf("[%lu] 电机运行时间到，已停止 / Motor run duration elapsed, stopped\n", millis());
+    LOG_I(LOG_RUN_DURATION_ELAPSED);
   }
 }
 
 // 处理MQTT消息：电机控制 / Handle MQTT message: motor control
 void handleMQTTMotorControl(String message) {
-  Serial.printf("[%lu] 处理MQTT电机控制消息: %s / Handling MQTT motor control message: %s\n", millis(), message.c_str(), message.c_str());
+  LOG_D(LOG_MQTT_MOTOR_COMMAND, message);
   updateMotorActivity(); // 更新电机活动时间戳 / Update motor activity timestamp
   if (message == "on") {
     motorEnabled = true;
     digitalWrite(ENABLE_PIN, LOW); // 使能电机 / Enable motor
     client.publish(mqtt_topic_status_report, "Motor On"); // 上报状态 / Report status
-    Serial.printf("[%lu] 电机已开启（通过MQTT） / Motor enabled (via MQTT)\n", millis());
+    LOG_I(LOG_MOTOR_ON_MQTT);
   } else if (message == "off") {
     motorEnabled = false;
     digitalWrite(ENABLE_PIN, HIGH); // 禁用电机 / Disable motor
     client.publish(mqtt_topic_status_report, "Motor Off"); // 上报状态 / Report status
-    Serial.printf("[%lu] 电机已关闭（通过MQTT） / Motor disabled (via MQTT)\n", millis());
+    LOG_I(LOG_MOTOR_OFF_MQTT);
   } else if (message == "forward") {
     motorDirection = true;
     stepDir = motorDirection;
     digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 设置为正转 / Set to forward
     client.publish(mqtt_topic_status_report, "Motor Forward"); // 上报状态 / Report status
-    Serial.printf("[%lu] 电机正转（通过MQTT） / Motor forward (via MQTT)\n", millis());
+    LOG_I(LOG_MOTOR_FORWARD_MQTT);
   } else if (message == "reverse") {
     motorDirection = false;
     stepDir = motorDirection;
     digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 设置为反转 / Set to reverse
     client.publish(mqtt_topic_status_report, "Motor Reverse"); // 上报状态 / Report status
-    Serial.printf("[%lu] 电机反转（通过MQTT） / Motor reverse (via MQTT)\n", millis());
+    LOG_I(LOG_MOTOR_REVERSE_MQTT);
   } else {
-    Serial.printf("[%lu] 未知的电机控制命令（通过MQTT）: %s / Unknown motor control command (via MQTT): %s\n", millis(), message.c_str(), message.c_str());
+    LOG_W(LOG_MQTT_UNKNOWN_COMMAND, message);
+  }
+}
+
+// =============================
+// PROGMEM 页面模板 / PROGMEM page templates
+// =============================
+// 模板直接从闪存分块发送，遇到 %NAME% 占位符时按变量类型输出：闪存文本、整数或调用输出函数；其他 % 字符（如CSS
+// 百分比）原样输出。整页从不复制到堆上，峰值内存与页面大小无关。
+// Templates are streamed from flash in chunks; a %NAME% placeholder is filled according to its variable's type: flash
+// text, an integer or a render function; any other % (such as CSS percentages) is sent as is. The page is never copied
+// to the heap, so peak memory does not depend on its size.
+#define TEMPLATE_NAME_MAX 32 // 占位符名称最大长度 / Max placeholder name length
+
+enum TemplateVarType : uint8_t {
+  TEMPLATE_TEXT_P, // 闪存中的文本 / Text in flash
+  TEMPLATE_NUMBER, // 十进制整数 / Decimal integer
+  TEMPLATE_RENDER, // 输出函数 / Render function
+};
+
+struct TemplateVar {
+  const char* name; // 占位符名称（不含%） / Placeholder name (without %)
+  TemplateVarType type;
+  PGM_P text;
+  long number;
+  void (*render)(); // 用 server.sendContent*() 输出内容 / Emits the content with server.sendContent*()
+};
+
+TemplateVar templateText_P(const char* name, PGM_P text) { return {name, TEMPLATE_TEXT_P, text, 0, nullptr}; }
+TemplateVar templateNumber(const char* name, long number) { return {name, TEMPLATE_NUMBER, nullptr, number, nullptr}; }
+TemplateVar templateRender(const char* name, void (*render)()) { return {name, TEMPLATE_RENDER, nullptr, 0, render}; }
+
+// 模板输出先合并到栈上的缓冲区，写满或调用输出函数前才发送一块，短页面只需一两块
+// Template output is gathered in a stack buffer and sent as a chunk only when full or before a render function runs, so
+// a short page takes one or two chunks
+#define TEMPLATE_BUFFER_SIZE 256 // 模板输出缓冲区大小 / Template output buffer size
+
+struct TemplateOutput {
+  char buffer[TEMPLATE_BUFFER_SIZE];
+  size_t len = 0;
+
+  void flush() {
+    if (len > 0) server.sendContent(buffer, len);
+    len = 0;
+  }
+
+  void append(const char* data, size_t n) {
+    while (n > 0) {
+      if (len == sizeof(buffer)) flush();
+      size_t part = n < sizeof(buffer) - len ? n : sizeof(buffer) - len;
+      memcpy(buffer + len, data, part);
+      len += part;
+      data += part;
+      n -= part;
+    }
+  }
+
+  void append_P(PGM_P data, size_t n) {
+    while (n > 0) {
+      if (len == sizeof(buffer)) flush();
+      size_t part = n < sizeof(buffer) - len ? n : sizeof(buffer) - len;
+      memcpy_P(buffer + len, data, part);
+      len += part;
+      data += part;
+      n -= part;
+    }
+  }
+};
+
+// 输出一个变量的值 / Emit one variable's value
+void sendTemplateVar(TemplateOutput& out, const TemplateVar& var) {
+  switch (var.type) {
+    case TEMPLATE_TEXT_P:
+      out.append_P(var.text, strlen_P(var.text));
+      break;
+    case TEMPLATE_NUMBER: {
+      char number[12];
+      int n = snprintf(number, sizeof(number), "%ld", var.number);
+      out.append(number, n);
+      break;
+    }
+    case TEMPLATE_RENDER:
+      out.flush(); // 输出函数直接发送，先发出之前的内容 / Render functions send directly; earlier output goes first
+      var.render();
+      break;
+  }
+}
+
+// 查找 tmpl[pos] 处的占位符，返回匹配的变量，并通过 end 返回结束位置 / Match a placeholder at tmpl[pos]; return the variable and its end offset
+const TemplateVar* matchTemplateVar(PGM_P tmpl, size_t pos, size_t len, const TemplateVar* vars, size_t varCount, size_t& end) {
+  char name[TEMPLATE_NAME_MAX + 1];
+  size_t n = 0;
+  for (end = pos + 1; end < len && n < TEMPLATE_NAME_MAX; end++) {
+    char c = pgm_read_byte(tmpl + end);
+    if (c == '%') break;
+    if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) return nullptr;
+    name[n++] = c;
+  }
+  if (n == 0 || end >= len || pgm_read_byte(tmpl + end) != '%') return nullptr;
+  name[n] = '\0';
+  end++; // 跳过结尾的% / Skip the closing %
+  for (size_t i = 0; i < varCount; i++) {
+    if (strcmp(vars[i].name, name) == 0) return &vars[i];
+  }
+  return nullptr;
+}
+
+// 以分块传输发送模板（需已调用 setContentLength(CONTENT_LENGTH_UNKNOWN) 和 send()） / Stream a template as chunks (after setContentLength(CONTENT_LENGTH_UNKNOWN) and send())
+void streamTemplate_P(PGM_P tmpl, const TemplateVar* vars, size_t varCount) {
+  TemplateOutput out;
+  size_t len = strlen_P(tmpl);
+  size_t runStart = 0; // 尚未发送的原文起点 / Start of the literal text not yet sent
+  size_t pos = 0;
+  while (pos < len) {
+    if (pgm_read_byte(tmpl + pos) != '%') {
+      pos++;
+      continue;
+    }
+    size_t end;
+    const TemplateVar* var = matchTemplateVar(tmpl, pos, len, vars, varCount, end);
+    if (!var) {
+      pos++;
+      continue;
+    }
+    if (pos > runStart) out.append_P(tmpl + runStart, pos - runStart);
+    sendTemplateVar(out, *var);
+    pos = end;
+    runStart = end;
+  }
+  if (len > runStart) out.append_P(tmpl + runStart, len - runStart);
+  out.flush();
+}
+
+// 以分块传输发送完整的HTML页面 / Send a complete HTML page with chunked transfer
+void sendTemplatePage_P(PGM_P tmpl, const TemplateVar* vars, size_t varCount) {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/html", "");
+  streamTemplate_P(tmpl, vars, varCount);
+  server.sendContent(""); // 结束分块传输 / Terminate the chunked response
+}
+
+// 操作结果页：弹出提示后跳转，OTA 等表单提交后使用 / Result page: show an alert, then redirect; used after form posts such as OTA
+const char RESULT_PAGE_TEMPLATE[] PROGMEM = R"rawliteral(<!DOCTYPE html>
+<html>
+<head>
+  <meta charset="UTF-8">
+  <script>
+    alert('%MESSAGE%');
+    setTimeout(function() { window.location.href = '%TARGET%'; }, %DELAY_MS%);
+  </script>
+</head>
+<body><h1>%MESSAGE%</h1></body>
+</html>
+)rawliteral";
+
+// 发送结果页，delayMs 后跳转到 target / Send a result page that redirects to target after delayMs
+void sendResultPage(TextMessageId message, PGM_P target, long delayMs) {
+  const TemplateVar vars[] = {
+    templateText_P("MESSAGE", (PGM_P)pgm_read_ptr(&TEXT_MESSAGE_TEXTS[message])),
+    templateText_P("TARGET", target),
+    templateNumber("DELAY_MS", delayMs),
+  };
+  sendTemplatePage_P(RESULT_PAGE_TEMPLATE, vars, sizeof(vars) / sizeof(vars[0]));
+}
+
+// =============================
+// 预压缩网页资源 / Pre-compressed web assets
+// =============================
+// 网页源文件位于 web/，编译前由 scripts/build_web_assets.py 压缩为 gzip 并生成 web_assets.h。
+// 页面地址固定，因此不让浏览器长期缓存（否则OTA升级后仍显示旧页面），而是每次用 ETag 重新验证，未变化时只回 304。
+// Page sources live in web/ and are gzipped into web_assets.h by scripts/build_web_assets.py before each build.
+// Page URLs are fixed, so browsers revalidate with the ETag on every load instead of caching for long (which would keep
+// showing the old UI after an OTA update); an unchanged page costs only a 304.
+void sendWebAsset(WebAssetId id) {
+  const WebAsset& asset = WEB_ASSETS[id];
+  server.sendHeader("ETag", asset.etag);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (server.header("If-None-Match") == asset.etag) {
+    server.send(304);
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, asset.contentType, (PGM_P)asset.data, asset.length);
+}
+
+// =============================
+// 流式JSON/CBOR输出 / Streaming JSON/CBOR writer
+// =============================
+// 同一套接口输出 JSON 或 CBOR（RFC 8949）。HTTP 请求带 Accept: application/cbor 或路径以 .cbor 结尾时输出 CBOR；
+// CBOR 的对象和数组使用不定长编码，写入前无需知道元素个数。输出直接写入栈上的固定缓冲区，不产生堆分配：HTTP 响应
+// 放得下时一次发送（带Content-Length），超出时自动切换为分块传输，每写满一次缓冲区发送一块；MQTT 负载只用缓冲区，
+// 写满即标记溢出。键名用 F("...") 保存在闪存中。
+// One interface writes JSON or CBOR (RFC 8949). An HTTP request with Accept: application/cbor, or a path ending in
+// .cbor, gets CBOR; CBOR objects and arrays use indefinite-length encoding, so item counts need not be known up front.
+// Output goes straight into a fixed buffer on the stack, with no heap allocation: an HTTP response that fits is sent in
+// one piece with Content-Length, a larger one switches to chunked transfer and sends a chunk per full buffer; an MQTT
+// payload only uses the buffer and is flagged as overflowed when it fills up. Keys are F("...") strings kept in flash.
+#define PAYLOAD_BUFFER_SIZE 256 // 输出缓冲区大小 / Output buffer size
+#define PAYLOAD_MAX_DEPTH 8 // 最大嵌套层数 / Max nesting depth
+
+// CBOR 主类型 / CBOR major types
+#define CBOR_UNSIGNED 0
+#define CBOR_NEGATIVE 1
+#define CBOR_TEXT 3
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+#define CBOR_SIMPLE 7
+#define CBOR_BREAK 0xFF // 不定长容器结束 / End of an indefinite-length container
+
+// 当前HTTP请求要求的格式 / Format asked for by the current HTTP request
+PayloadFormat requestedFormat() {
+  if (server.uri().endsWith(".cbor")) return FORMAT_CBOR;
+  return server.header("Accept").indexOf("application/cbor") >= 0 ? FORMAT_CBOR : FORMAT_JSON;
+}
+
+class PayloadWriter {
+public:
+  // HTTP 响应，格式按当前请求协商 / HTTP response, format negotiated from the current request
+  explicit PayloadWriter(int code = 200) : code(code), format(requestedFormat()), http(true) {}
+  // 只写入缓冲区（如MQTT负载），用 data()/length() 取出 / Buffer only (e.g. an MQTT payload), read back with data()/length()
+  explicit PayloadWriter(PayloadFormat format) : code(0), format(format), http(false) {}
+
+  PayloadWriter& beginObject() {
+    separator();
+    if (format == FORMAT_CBOR) {
+      put((CBOR_MAP << 5) | 31);
+    } else {
+      put('{');
+    }
+    push();
+    return *this;
+  }
+  PayloadWriter& endObject() { pop(); put(format == FORMAT_CBOR ? CBOR_BREAK : '}'); return *this; }
+  PayloadWriter& beginArray() {
+    separator();
+    if (format == FORMAT_CBOR) {
+      put((CBOR_ARRAY << 5) | 31);
+    } else {
+      put('[');
+    }
+    push();
+    return *this;
+  }
+  PayloadWriter& endArray() { pop(); put(format == FORMAT_CBOR ? CBOR_BREAK : ']'); return *this; }
+
+  // 写入键名，随后必须写一个值或对象/数组 / Write a key; a value, object or array must follow
+  PayloadWriter& key(const __FlashStringHelper* name) {
+    separator();
+    PGM_P p = (PGM_P)name;
+    if (format == FORMAT_CBOR) {
+      putHead(CBOR_TEXT, strlen_P(p));
+      putRaw_P(p);
+      return *this;
+    }
+    put('"');
+    putRaw_P(p); // 键名均为标识符，无需转义 / Keys are identifiers, no escaping needed
+    put('"');
+    put(':');
+    afterKey = true;
+    return *this;
+  }
+  // 内存中的键名（如名称表） / Key held in RAM (e.g. a name table)
+  PayloadWriter& key(const char* name) {
+    separator();
+    if (format == FORMAT_CBOR) {
+      size_t n = strlen(name);
+      putHead(CBOR_TEXT, n);
+      while (n--) put(*name++);
+      return *this;
+    }
+    put('"');
+    while (*name) put(*name++);
+    put('"');
+    put(':');
+    afterKey = true;
+    return *this;
+  }
+
+  PayloadWriter& value(const char* s) { separator(); putString(s ? s : "", s ? strlen(s) : 0); return *this; }
+  PayloadWriter& value(const String& s) { separator(); putString(s.c_str(), s.length()); return *this; }
+  PayloadWriter& value(const __FlashStringHelper* s) { separator(); putString_P((PGM_P)s); return *this; }
+  PayloadWriter& value(bool b) {
+    separator();
+    if (format == FORMAT_CBOR) {
+      put((CBOR_SIMPLE << 5) | (b ? 21 : 20));
+    } else {
+      putRaw_P(b ? PSTR("true") : PSTR("false"));
+    }
+    return *this;
+  }
+  PayloadWriter& value(int v) { return value((long long)v); }
+  PayloadWriter& value(long v) { return value((long long)v); }
+  PayloadWriter& value(unsigned int v) { return value((unsigned long long)v); }
+  PayloadWriter& value(unsigned long v) { return value((unsigned long long)v); }
+  PayloadWriter& value(long long v) {
+    separator();
+    if (v >= 0) {
+      putUnsigned((unsigned long long)v);
+    } else if (format == FORMAT_CBOR) {
+      putHead(CBOR_NEGATIVE, (unsigned long long)(-(v + 1))); // CBOR负数编码为 -1-n / CBOR encodes negatives as -1-n
+    } else {
+      put('-');
+      putUnsigned(0ULL - (unsigned long long)v);
+    }
+    return *this;
+  }
+  PayloadWriter& value(unsigned long long v) { separator(); putUnsigned(v); return *this; }
+  PayloadWriter& nullValue() {
+    separator();
+    if (format == FORMAT_CBOR) {
+      put((CBOR_SIMPLE << 5) | 22);
+    } else {
+      putRaw_P(PSTR("null"));
+    }
+    return *this;
+  }
+
+  // 键值对 / Key-value pair
+  template <typename T>
+  PayloadWriter& field(const __FlashStringHelper* name, const T& v) { key(name); return value(v); }
+
+  // 结束并发送HTTP响应 / Finish and send the HTTP response
+  void send() {
+    if (streaming) {
+      if (len > 0) server.sendContent(buffer, len);
+      server.sendContent(""); // 结束分块传输 / Terminate the chunked response
+    } else {
+      server.send(code, contentType(), (const uint8_t*)buffer, len);
+    }
+  }
+
+  // 缓冲区模式的结果 / Result in buffer mode
+  const uint8_t* data() const { return (const uint8_t*)buffer; }
+  size_t length() const { return len; }
+  bool overflowed() const { return overflow; }
+
+private:
+  char buffer[PAYLOAD_BUFFER_SIZE];
+  size_t len = 0;
+  int code;
+  PayloadFormat format;
+  bool http; // 输出到当前HTTP响应 / Output goes to the current HTTP response
+  bool streaming = false; // 已切换为分块传输 / Switched to chunked transfer
+  bool overflow = false; // 缓冲区模式下写满 / Buffer filled up in buffer mode
+  bool afterKey = false; // 刚写完键名 / A key was just written
+  uint8_t depth = 0;
+  uint8_t hasItems = 0; // 每层是否已有元素（按位） / Whether each level has items yet (bitmask)
+
+  const char* contentType() const { return format == FORMAT_CBOR ? "application/cbor" : "application/json"; }
+
+  // JSON 元素之间的逗号；CBOR 不需要分隔符 / Comma between JSON items; CBOR needs no separators
+  void separator() {
+    if (format == FORMAT_CBOR) return;
+    if (afterKey) {
+      afterKey = false;
+      return;
+    }
+    if (depth == 0) return;
+    uint8_t bit = 1 << (depth - 1);
+    if (hasItems & bit) put(',');
+    hasItems |= bit;
+  }
+
+  void push() {
+    if (depth < PAYLOAD_MAX_DEPTH) depth++;
+    hasItems &= ~(1 << (depth - 1));
+  }
+
+  void pop() {
+    if (depth > 0) depth--;
+  }
+
+  void put(char c) {
+    if (len == sizeof(buffer)) {
+      if (!http) {
+        overflow = true;
+        return;
+      }
+      flush();
+    }
+    buffer[len++] = c;
+  }
+
+  void putRaw_P(PGM_P s) {
+    for (char c = pgm_read_byte(s); c; c = pgm_read_byte(++s)) put(c);
+  }
+
+  // CBOR 项头：主类型 + 长度或数值，按大小选用 0/1/2/4/8 字节 / CBOR item head: major type plus length or value in 0/1/2/4/8 bytes
+  void putHead(uint8_t major, unsigned long long v) {
+    uint8_t m = major << 5;
+    if (v < 24) {
+      put(m | v);
+      return;
+    }
+    int bytes = v <= 0xFF ? 1 : v <= 0xFFFF ? 2 : v <= 0xFFFFFFFFULL ? 4 : 8;
+    put(m | (bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27));
+    while (bytes--) put((char)(v >> (bytes * 8)));
+  }
+
+  void putUnsigned(unsigned long long v) {
+    if (format == FORMAT_CBOR) {
+      putHead(CBOR_UNSIGNED, v);
+      return;
+    }
+    char digits[20];
+    int n = 0;
+    do {
+      digits[n++] = '0' + v % 10;
+      v /= 10;
+    } while (v > 0);
+    while (n > 0) put(digits[--n]);
+  }
+
+  void putString(const char* s, size_t n) {
+    if (format == FORMAT_CBOR) {
+      putHead(CBOR_TEXT, n);
+      for (size_t i = 0; i < n; i++) put(s[i]);
+      return;
+    }
+    put('"');
+    for (size_t i = 0; i < n; i++) {
+      char c = s[i];
+      if (c == '"' || c == '\\') {
+        put('\\');
+        put(c);
+      } else if ((uint8_t)c < 0x20) {
+        static const char hex[] PROGMEM = "0123456789abcdef";
+        putRaw_P(PSTR("\\u00"));
+        put(pgm_read_byte(hex + ((uint8_t)c >> 4)));
+        put(pgm_read_byte(hex + (c & 0x0F)));
+      } else {
+        put(c);
+      }
+    }
+    put('"');
+  }
+
+  // 闪存中的字符串值，内容为固定文本，无需转义 / String value in flash; fixed text, no escaping needed
+  void putString_P(PGM_P s) {
+    if (format == FORMAT_CBOR) {
+      putHead(CBOR_TEXT, strlen_P(s));
+      putRaw_P(s);
+      return;
+    }
+    put('"');
+    putRaw_P(s);
+    put('"');
+  }
+
+  // 缓冲区写满：首次切换为分块传输，然后发送一块 / Buffer full: switch to chunked transfer on first use, then send a chunk
+  void flush() {
+    if (!streaming) {
+      server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+      server.send(code, contentType(), "");
+      streaming = true;
+    }
+    server.sendContent(buffer, len);
+    len = 0;
+  }
+};
+
+// =============================
+// 流式CBOR读取 / Streaming CBOR reader
+// =============================
+// 直接在输入字节上逐项读取，不建树、不分配内存，文本以指针加长度返回（指向输入本身）。用于 HTTP 请求体和 MQTT
+// 负载中的控制命令；只支持命令需要的类型：整数、定长文本、数组、映射和简单值。
+// Reads item by item straight off the input bytes, with no tree and no allocation; text comes back as pointer plus
+// length into the input itself. Used for control commands in HTTP bodies and MQTT payloads; only the types commands
+// need are supported: integers, definite-length text, arrays, maps and simple values.
+#define CBOR_MAX_DEPTH 4 // 跳过嵌套项的最大层数 / Max nesting when skipping items
+
+class CborReader {
+public:
+  CborReader(const uint8_t* data, size_t length) : p(data), end(data + length) {}
+
+  bool ok() const { return !failed; }
+  bool atEnd() const { return p >= end; }
+
+  // 读取项头；不定长容器 indefinite 为 true / Read an item head; indefinite is true for indefinite-length containers
+  bool readHead(uint8_t& major, unsigned long long& value, bool& indefinite) {
+    if (p >= end) return fail();
+    uint8_t b = *p++;
+    major = b >> 5;
+    uint8_t info = b & 0x1F;
+    indefinite = false;
+    value = 0;
+    if (info < 24) {
+      value = info;
+    } else if (info <= 27) {
+      int bytes = 1 << (info - 24);
+      if (end - p < bytes) return fail();
+      while (bytes--) value = (value << 8) | *p++;
+    } else if (info == 31 && (major == CBOR_ARRAY || major == CBOR_MAP)) {
+      indefinite = true;
+    } else {
+      return fail(); // 不支持的编码 / Unsupported encoding
+    }
+    return true;
+  }
+
+  // 不定长容器的结束标记，遇到时消费并返回 true / Break marker of an indefinite container; consumed when present
+  bool readBreak() {
+    if (p < end && *p == CBOR_BREAK) {
+      p++;
+      return true;
+    }
+    return false;
+  }
+
+  // 读取定长文本，返回指向输入的指针 / Read definite-length text, returning a pointer into the input
+  bool readText(const char*& text, size_t& length) {
+    uint8_t major;
+    unsigned long long n;
+    bool indefinite;
+    if (!readHead(major, n, indefinite) || major != CBOR_TEXT || n > (unsigned long long)(end - p)) return fail();
+    text = (const char*)p;
+    length = n;
+    p += n;
+    return true;
+  }
+
+  // 读取整数（正负均可） / Read an integer (either sign)
+  bool readInt(long long& v) {
+    uint8_t major;
+    unsigned long long n;
+    bool indefinite;
+    if (!readHead(major, n, indefinite)) return false;
+    if (major == CBOR_UNSIGNED) {
+      v = (long long)n;
+    } else if (major == CBOR_NEGATIVE) {
+      v = -1 - (long long)n;
+    } else {
+      return fail();
+    }
+    return true;
+  }
+
+  // 查看下一项的主类型，不消费 / Peek at the major type of the next item without consuming it
+  int peekMajor() const { return p < end ? *p >> 5 : -1; }
+
+  // 跳过一个完整的项 / Skip one complete item
+  bool skip(uint8_t depth = 0) {
+    if (depth > CBOR_MAX_DEPTH) return fail();
+    uint8_t major;
+    unsigned long long n;
+    bool indefinite;
+    if (!readHead(major, n, indefinite)) return false;
+    switch (major) {
+      case 2:
+      case CBOR_TEXT:
+        if (n > (unsigned long long)(end - p)) return fail();
+        p += n;
+        return true;
+      case CBOR_ARRAY:
+      case CBOR_MAP: {
+        unsigned long long items = major == CBOR_MAP ? n * 2 : n;
+        if (indefinite) {
+          while (!readBreak()) {
+            if (!skip(depth + 1)) return false;
+          }
+          return true;
+        }
+        while (items--) {
+          if (!skip(depth + 1)) return false;
+        }
+        return true;
+      }
+      default:
+        return true; // 整数和简单值的项头就是全部 / For integers and simple values the head is the whole item
+    }
+  }
+
+private:
+  const uint8_t* p;
+  const uint8_t* end;
+  bool failed = false;
+
+  bool fail() {
+    failed = true;
+    p = end;
+    return false;
+  }
+};
+
+// 首字节是否为 CBOR 数组或映射（与文本负载不会混淆） / Whether the first byte starts a CBOR array or map (never
+// confused with a text payload)
+bool isCborContainer(const uint8_t* data, size_t length) {
+  return length > 0 && (data[0] >> 5 == CBOR_ARRAY || data[0] >> 5 == CBOR_MAP);
+}
+
+// 在顶层 CBOR 映射中查找键，文本值原样复制，整数转为十进制文本 / Look a key up in a top-level CBOR map; text values are
+// copied, integers are turned into decimal text
+bool cborMapLookup(const uint8_t* data, size_t length, PGM_P key, char* out, size_t size) {
+  CborReader reader(data, length);
+  uint8_t major;
+  unsigned long long count;
+  bool indefinite;
+  if (!reader.readHead(major, count, indefinite) || major != CBOR_MAP) return false;
+  size_t keyLen = strlen_P(key);
+  while (indefinite ? !reader.readBreak() : count-- > 0) {
+    const char* name;
+    size_t nameLen;
+    if (reader.peekMajor() != CBOR_TEXT) {
+      if (!reader.skip() || !reader.skip()) return false; // 非文本键 / Non-text key
+      continue;
+    }
+    if (!reader.readText(name, nameLen)) return false;
+    if (nameLen != keyLen || strncmp_P(name, key, keyLen) != 0) {
+      if (!reader.skip()) return false;
+      continue;
+    }
+    if (reader.peekMajor() == CBOR_TEXT) {
+      const char* text;
+      size_t textLen;
+      if (!reader.readText(text, textLen) || textLen >= size) return false;
+      memcpy(out, text, textLen);
+      out[textLen] = '\0';
+      return true;
+    }
+    long long v;
+    if (!reader.readInt(v)) return false;
+    snprintf_P(out, size, PSTR("%lld"), v);
+    return true;
+  }
+  return false;
+}
+
+// 控制接口的参数：先取查询/表单参数，没有时查 CBOR 请求体 / Control API parameter: the query/form argument, or else
+// the CBOR request body
+String requestArg(PGM_P name) {
+  String arg = server.arg(FPSTR(name));
+  if (arg.length() > 0) return arg;
+  size_t length;
+  const uint8_t* body = server.rawBody(length);
+  char value[32];
+  if (body && isCborContainer(body, length) && cborMapLookup(body, length, name, value, sizeof(value))) return String(value);
+  return String();
+}
+
+// 状态变化时向 motor/telemetry 发布 CBOR 遥测（保留消息），编码与 HTTP 接口共用 PayloadWriter
+// Publish CBOR telemetry to motor/telemetry (retained) on state changes, encoded by the same PayloadWriter as HTTP
+EventState telemetryLastState = {};
+bool telemetryPublished = false; // 当前连接是否已发布过 / Whether the current connection got a publish yet
+
+void publishTelemetry() {
+  if (!mqttControlEnabled || !client.connected()) {
+    telemetryPublished = false; // 重连后重新发布 / Publish again after reconnecting
+    return;
+  }
+  EventState state = captureEventState();
+  if (telemetryPublished && sameEventState(state, telemetryLastState)) return;
+  PayloadWriter out(FORMAT_CBOR);
+  out.beginObject()
+      .field(F("enabled"), state.enabled)
+      .field(F("direction"), state.forward ? F("forward") : F("reverse"))
+      .field(F("stepIntervalUs"), state.stepInterval)
+      .field(F("microstep"), state.microstep)
+      .field(F("position"), motorPosition)
+      .field(F("onlineClients"), (unsigned)clients.size())
+      .endObject();
+  if (out.overflowed()) return;
+  if (client.publish(mqtt_topic_telemetry, out.data(), out.length(), true)) {
+    telemetryLastState = state;
+    telemetryPublished = true;
   }
 }
 
+// 以 CBOR 发送提示文字：{"ok":<是否成功>,"msg":<文字>} / Send a text message as CBOR: {"ok":<success>,"msg":<text>}
+void sendCborTextMessage(int code, PGM_P text) {
+  PayloadWriter out(code);
+  out.beginObject().field(F("ok"), code < 400).field(F("msg"), FPSTR(text)).endObject();
+  out.send();
+}
+
 // 处理Web请求：主页 / Handle web request: root
 void handleRoot() {
-  String html = MAIN_HTML;
-  html.replace("%MICROSTEP_OPTIONS%", MICROSTEP_OPTIONS_HTML);
-  server.send(200, "text/html", html);
+  sendWebAsset(WEB_ASSET_INDEX);
 }
 
 // 处理Web请求：开启电机 / Handle web request: motor on
@@ -949,10 +3068,9 @@ void handleMotorOn() {
     motorStartTime = millis(); // 记录启动时间 / Record start time
     digitalWrite(ENABLE_PIN, LOW); // 启动电机 / Enable motor
     updateMotorActivity(); // 更新电机活动时间戳 / Update motor activity timestamp
-    Serial.printf("[%lu] 电机已开启（通过网页） / Motor enabled (via web)\n", millis());
+    LOG_I(LOG_MOTOR_ON_WEB);
   }
-  server.sendHeader("Content-Type", "text/plain; charset=utf-8");
-  server.send(200, "text/plain", "电机已开启 / Motor enabled");
+  sendTextMessage(200, MSG_MOTOR_ON);
 }
 
 // 处理Web请求：关闭电机 / Handle web request: motor off
@@ -960,10 +3078,9 @@ void handleMotorOff() {
   if (motorEnabled) {
     motorEnabled = false;
     digitalWrite(ENABLE_PIN, HIGH); // 禁用电机 / Disable motor
-    Serial.printf("[%lu] 电机已关闭（通过网页） / Motor disabled (via web)\n", millis());
+    LOG_I(LOG_MOTOR_OFF_WEB);
   }
-  server.sendHeader("Content-Type", "text/plain; charset=utf-8");
-  server.send(200, "text/plain", "电机已关闭 / Motor disabled");
+  sendTextMessage(200, MSG_MOTOR_OFF);
 }
 
 // 处理Web请求：切换电机方向 / Handle web request: toggle motor direction
@@ -971,181 +3088,101 @@ void handleMotorDirection() {
   motorDirection = !motorDirection;
   stepDir = motorDirection;
   digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 设置电机方向 / Set motor direction
-  Serial.printf("[%lu] 电机方向已切换为: %s（通过网页） / Motor direction toggled to: %s (via web)\n", millis(), motorDirection ? "正转 / Forward" : "反转 / Reverse", motorDirection ? "正转 / Forward" : "反转 / Reverse");
-  server.sendHeader("Content-Type", "text/plain; charset=utf-8");
-  server.send(200, "text/plain", motorDirection ? "电机正转 / Motor forward" : "电机反转 / Motor reverse");
+  if (motorDirection) {
+    LOG_I(LOG_DIRECTION_FORWARD_WEB);
+  } else {
+    LOG_I(LOG_DIRECTION_REVERSE_WEB);
+  }
+  sendTextMessage(200, motorDirection ? MSG_MOTOR_FORWARD : MSG_MOTOR_REVERSE);
 }
 
 // 处理API请求：电机控制 / Handle API request: motor control
 void handleMotorAPI() {
-  if (server.hasArg("command")) {
-    String command = server.arg("command");
-    Serial.printf("[%lu] 收到API请求，命令: %s / Received API request, command: %s\n", getTimestamp(), command.c_str(), command.c_str());
+  String command = requestArg(PSTR("command"));
+  if (!admitParsedRequest(command == "off")) return;
+  if (command.length() > 0) {
+    LOG_D(LOG_API_COMMAND, command);
     updateMotorActivity(); // 更新电机活动时间戳 / Update motor activity timestamp
     if (command == "on") {
       motorEnabled = true;
       digitalWrite(ENABLE_PIN, LOW); // 使能电机 / Enable motor
-      server.send(200, "text/plain", "电机已开启 / Motor enabled");
-      Serial.printf("[%lu] 电机已开启（通过API） / Motor enabled (via API)\n", getTimestamp());
+      sendTextMessage(200, MSG_MOTOR_ON);
+      LOG_I(LOG_MOTOR_ON_API);
     } else if (command == "off") {
       motorEnabled = false;
       digitalWrite(ENABLE_PIN, HIGH); // 禁用电机 / Disable motor
-      server.send(200, "text/plain", "电机已关闭 / Motor disabled");
-      Serial.printf("[%lu] 电机已关闭（通过API） / Motor disabled (via API)\n", getTimestamp());
+      sendTextMessage(200, MSG_MOTOR_OFF);
+      LOG_I(LOG_MOTOR_OFF_API);
     } else if (command == "forward") {
       motorDirection = true;
       stepDir = motorDirection;
       digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 设置为正转 / Set to forward
-      server.send(200, "text/plain", "电机正转 / Motor forward");
-      Serial.printf("[%lu] 电机正转（通过API） / Motor forward (via API)\n", getTimestamp());
+      sendTextMessage(200, MSG_MOTOR_FORWARD);
+      LOG_I(LOG_MOTOR_FORWARD_API);
     } else if (command == "reverse") {
       motorDirection = false;
       stepDir = motorDirection;
       digitalWrite(DIR_PIN, stepDir ? HIGH : LOW); // 设置为反转 / Set to reverse
-      server.send(200, "text/plain", "电机反转 / Motor reverse");
-      Serial.printf("[%lu] 电机反转（通过API） / Motor reverse (via API)\n", getTimestamp());
+      sendTextMessage(200, MSG_MOTOR_REVERSE);
+      LOG_I(LOG_MOTOR_REVERSE_API);
     } else {
-      server.send(400, "text/plain", "未知命令 / Unknown command");
-      Serial.printf("[%lu] 收到未知命令（通过API） / Unknown command received (via API)\n", getTimestamp());
+      sendTextMessage(400, MSG_UNKNOWN_COMMAND);
+      LOG_W(LOG_API_UNKNOWN_COMMAND);
     }
   } else {
-    server.send(400, "text/plain", "缺少命令参数 / Missing command parameter");
-    Serial.printf("[%lu] API请求缺少命令参数 / API request missing command parameter\n", getTimestamp());
+    sendTextMessage(400, MSG_MISSING_COMMAND);
+    LOG_W(LOG_API_MISSING_COMMAND);
   }
 }
 
 // 处理Web请求：获取版本信息 / Handle web request: get version information
 void handleVersionInfo() {
-  String versionInfo = String("固件版本: ") + FIRMWARE_VERSION + " / Firmware Version: " + FIRMWARE_VERSION;
-  server.send(200, "text/plain", versionInfo);
+  server.send_P(200, PSTR("text/plain; charset=utf-8"), PSTR(MSG_TEXT("固件版本: " FIRMWARE_VERSION, "Firmware Version: " FIRMWARE_VERSION)));
 }
 
 // 处理OTA升级界面 / Handle OTA upgrade page
 void handleOTA() {
-  String html = R"rawliteral(
-    <!DOCTYPE html>
-    <html>
-    <head>
-      <meta charset="UTF-8">
-      <title>OTA 升级</title>
-      <style>
-        body { font-family: Arial, sans-serif; text-align: center; margin: 20px; }
-        h1 { color: #333; }
-        p { font-size: 16px; }
-        input[type="file"], button, input[type="text"] { padding: 10px; margin: 10px; font-size: 16px; }
-        button { background-color: #4CAF50; color: white; border: none; cursor: pointer; }
-        button:hover { background-color: #45a049; }
-        input[type="text"] { width: 300px; }
-      </style>
-    </head>
-    <body>
-      <h1>OTA 升级</h1>
-      <p>通过以下方式上传固件文件或指定远程地址进行升级。</p>
-      <h2>上传固件文件</h2>
-      <form method="POST" action="/ota/upload" enctype="multipart/form-data">
-        <input type="file" name="firmware">
-        <button type="submit">上传并升级</button>
-      </form>
-      <h2>远程升级</h2>
-      <form method="POST" action="/ota/remote">
-        <input type="text" name="url" placeholder="输入远程固件地址" required>
-        <button type="submit">开始远程升级</button>
-      </form>
-      <button onclick="location.href='/'">返回主页面</button>
-    </body>
-    </html>
-  )rawliteral";
-
-  server.send(200, "text/html", html);
+  sendWebAsset(WEB_ASSET_OTA);
 }
 
 // 处理OTA文件上传 / Handle OTA file upload
 void handleOTAUpload() {
+  stallMark(STALL_OTA); // 写入闪存可能耗时较长 / Flash writes may take long
   HTTPUpload& upload = server.upload();
   if (upload.status == UPLOAD_FILE_START) {
-    Serial.printf("开始上传固件: %s\n", upload.filename.c_str());
+    LOG_I(LOG_OTA_UPLOAD_START, upload.filename);
     size_t maxSketchSpace = (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000; // 获取最大可用空间 / Get maximum available space
     if (!Update.begin(maxSketchSpace)) { // 初始化OTA更新 / Initialize OTA update
-      Serial.printf("OTA初始化失败，错误代码: %d\n", Update.getError()); // 输出错误代码 / Print error code
-      server.send(200, "text/html", R"rawliteral(
-        <!DOCTYPE html>
-        <html>
-        <head>
-          <meta charset="UTF-8">
-          <script>
-            alert('OTA初始化失败 / OTA initialization failed');
-            window.location.href = '/ota';
-          </script>
-        </head>
-        <body></body>
-        </html>
-      )rawliteral");
+      LOG_E(LOG_OTA_BEGIN_FAILED, Update.getError()); // 输出错误代码 / Print error code
+      sendResultPage(MSG_OTA_BEGIN_FAILED, PSTR("/ota"), 0);
       return;
     }
   } else if (upload.status == UPLOAD_FILE_WRITE) {
     if (Update.write(upload.buf, upload.currentSize) != upload.currentSize) {
-      Serial.printf("OTA写入失败，错误代码: %d\n", Update.getError()); // 输出错误代码 / Print error code
-      server.send(200, "text/html", R"rawliteral(
-        <!DOCTYPE html>
-        <html>
-        <head>
-          <meta charset="UTF-8">
-          <script>
-            alert('OTA写入失败 / OTA write failed');
-            window.location.href = '/ota';
-          </script>
-        </head>
-        <body></body>
-        </html>
-      )rawliteral");
+      LOG_E(LOG_OTA_WRITE_FAILED, Update.getError()); // 输出错误代码 / Print error code
+      sendResultPage(MSG_OTA_WRITE_FAILED, PSTR("/ota"), 0);
       return;
     }
   } else if (upload.status == UPLOAD_FILE_END) {
     if (Update.end(true)) { // 完成OTA更新 / Finish OTA update
-      Serial.println("OTA更新成功 / OTA update successful");
-      // 恢复为原先的弹窗+网页
-      server.send(200, "text/html", R"rawliteral(
-        <!DOCTYPE html>
-        <html>
-        <head>
-          <meta charset="UTF-8">
-          <script>
-            alert('OTA更新成功，设备将在5秒后重启 / OTA update successful, device will restart in 5 seconds');
-            setTimeout(() => { window.location.href = '/'; }, 5000);
-          </script>
-        </head>
-        <body>
-          <h1>OTA更新成功 / OTA Update Successful</h1>
-          <p>设备将在5秒后重启 / The device will restart in 5 seconds.</p>
-        </body>
-        </html>
-      )rawliteral");
+      LOG_I(LOG_OTA_SUCCESS);
+      sendResultPage(MSG_OTA_SUCCESS, PSTR("/"), 5000);
       delay(5000); // 延迟5秒以显示成功信息 / Delay 5 seconds to show success message
+      logFlush(); // 重启前输出全部日志 / Flush all logs before restarting
       ESP.restart(); // 重启设备 / Restart device
     } else {
-      Serial.printf("OTA更新失败，错误代码: %d\n", Update.getError()); // 输出错误代码 / Print error code
-      server.send(200, "text/html", R"rawliteral(
-        <!DOCTYPE html>
-        <html>
-        <head>
-          <meta charset="UTF-8">
-          <script>
-            alert('OTA更新失败 / OTA update failed');
-            window.location.href = '/ota';
-          </script>
-        </head>
-        <body></body>
-        </html>
-      )rawliteral");
+      LOG_E(LOG_OTA_FAILED, Update.getError()); // 输出错误代码 / Print error code
+      sendResultPage(MSG_OTA_FAILED, PSTR("/ota"), 0);
     }
   }
 }
 
 // 处理远程OTA升级 / Handle remote OTA upgrade
 void handleOTARemote() {
+  stallMark(STALL_OTA); // 下载和写入固件期间阻塞主循环 / Download and flashing block the loop
   if (server.hasArg("url")) {
     String url = server.arg("url");
-    Serial.printf("开始远程OTA升级，地址: %s\n", url.c_str());
+    LOG_I(LOG_OTA_REMOTE_START, url);
     WiFiClient client;
     HTTPClient http;
 
@@ -1158,116 +3195,33 @@ void handleOTARemote() {
             WiFiClient* stream = http.getStreamPtr();
             size_t written = Update.writeStream(*stream);
             if (written == contentLength && Update.end()) {
-              Serial.println("远程OTA更新成功 / Remote OTA update successful");
-              server.send(200, "text/html", R"rawliteral(
-                <!DOCTYPE html>
-                <html>
-                <head>
-                  <meta charset="UTF-8">
-                  <script>
-                    alert('远程OTA更新成功，设备即将重启 / Remote OTA update successful, device will restart');
-                    window.location.href = '/';
-                  </script>
-                </head>
-                <body></body>
-                </html>
-              )rawliteral");
+              LOG_I(LOG_OTA_REMOTE_SUCCESS);
+              sendResultPage(MSG_OTA_REMOTE_SUCCESS, PSTR("/"), 0);
+              logFlush(); // 重启前输出全部日志 / Flush all logs before restarting
               ESP.restart(); // 重启设备 / Restart device
             } else {
-              Serial.printf("远程OTA更新失败，错误代码: %d\n", Update.getError());
-              server.send(200, "text/html", R"rawliteral(
-                <!DOCTYPE html>
-                <html>
-                <head>
-                  <meta charset="UTF-8">
-                  <script>
-                    alert('远程OTA更新失败 / Remote OTA update failed');
-                    window.location.href = '/ota';
-                  </script>
-                </head>
-                <body></body>
-                </html>
-              )rawliteral");
+              LOG_E(LOG_OTA_REMOTE_FAILED, Update.getError());
+              sendResultPage(MSG_OTA_REMOTE_FAILED, PSTR("/ota"), 0);
             }
           } else {
-            Serial.printf("OTA初始化失败，错误代码: %d\n", Update.getError());
-            server.send(200, "text/html", R"rawliteral(
-              <!DOCTYPE html>
-              <html>
-              <head>
-                <meta charset="UTF-8">
-                <script>
-                  alert('OTA初始化失败 / OTA initialization failed');
-                  window.location.href = '/ota';
-                </script>
-              </head>
-              <body></body>
-              </html>
-            )rawliteral");
+            LOG_E(LOG_OTA_BEGIN_FAILED, Update.getError());
+            sendResultPage(MSG_OTA_BEGIN_FAILED, PSTR("/ota"), 0);
           }
         } else {
-          Serial.println("远程固件大小无效 / Invalid firmware size");
-          server.send(200, "text/html", R"rawliteral(
-            <!DOCTYPE html>
-            <html>
-            <head>
-              <meta charset="UTF-8">
-              <script>
-                alert('远程固件大小无效 / Invalid firmware size');
-                window.location.href = '/ota';
-              </script>
-            </head>
-            <body></body>
-            </html>
-          )rawliteral");
+          LOG_E(LOG_OTA_REMOTE_BAD_SIZE);
+          sendResultPage(MSG_OTA_BAD_SIZE, PSTR("/ota"), 0);
         }
       } else {
-        Serial.printf("HTTP请求失败，状态码: %d\n", httpCode);
-        server.send(200, "text/html", R"rawliteral(
-          <!DOCTYPE html>
-          <html>
-          <head>
-            <meta charset="UTF-8">
-            <script>
-              alert('HTTP请求失败 / HTTP request failed');
-              window.location.href = '/ota';
-            </script>
-          </head>
-          <body></body>
-          </html>
-        )rawliteral");
+        LOG_E(LOG_OTA_REMOTE_HTTP_FAILED, httpCode);
+        sendResultPage(MSG_OTA_HTTP_FAILED, PSTR("/ota"), 0);
       }
       http.end();
     } else {
-      Serial.println("无法连接到远程地址 / Unable to connect to remote URL");
-      server.send(200, "text/html", R"rawliteral(
-        <!DOCTYPE html>
-        <html>
-        <head>
-          <meta charset="UTF-8">
-          <script>
-            alert('无法连接到远程地址 / Unable to connect to remote URL');
-            window.location.href = '/ota';
-          </script>
-        </head>
-        <body></body>
-        </html>
-      )rawliteral");
+      LOG_E(LOG_OTA_REMOTE_UNREACHABLE);
+      sendResultPage(MSG_OTA_UNREACHABLE, PSTR("/ota"), 0);
     }
   } else {
-    server.send(200, "text/html", R"rawliteral(
-      <!DOCTYPE html>
-      <html>
-      <head>
-        <meta charset="UTF-8">
-        <script>
-          alert('缺少远程地址参数 / Missing remote URL parameter');
-          window.location.href = '/ota';
-      </script>
-      </head>
-      <body></body>
-      </html>
-    )rawliteral");
+    sendResultPage(MSG_OTA_MISSING_URL, PSTR("/ota"), 0);
   }
 }
 
@@ -1278,108 +3232,194 @@ void handleToggleMQTTControl() {
     if (enable == "true") {
       mqttControlEnabled = true;
       client.setServer(mqtt_server, 1883); // 设置MQTT服务器地址 / Set MQTT server address
-      Serial.println("MQTT控制已启用 / MQTT control enabled");
-      server.send(200, "text/plain; charset=utf-8", "MQTT控制已启用 / MQTT control enabled");
+      LOG_I(LOG_MQTT_CONTROL_ENABLED);
+      sendTextMessage(200, MSG_MQTT_CONTROL_ENABLED);
     } else if (enable == "false") {
       mqttControlEnabled = false;
       client.unsubscribe(mqtt_topic_motor_control); // 取消订阅主题 / Unsubscribe from topic
       client.disconnect(); // 禁用时断开MQTT连接 / Disconnect MQTT when disabled
-      Serial.println("MQTT控制已禁用 / MQTT control disabled");
-      server.send(200, "text/plain; charset=utf-8", "MQTT控制已禁用 / MQTT control disabled");
+      LOG_I(LOG_MQTT_CONTROL_DISABLED);
+      sendTextMessage(200, MSG_MQTT_CONTROL_DISABLED);
     } else {
-      server.send(400, "text/plain; charset=utf-8", "无效参数 / Invalid parameter");
-      Serial.println("无效的MQTT控制参数 / Invalid MQTT control parameter");
+      sendTextMessage(400, MSG_INVALID_PARAMETER);
+      LOG_W(LOG_MQTT_CONTROL_INVALID);
     }
   } else {
-    server.send(400, "text/plain; charset=utf-8", "缺少参数 / Missing parameter");
-    Serial.println("缺少MQTT控制参数 / Missing MQTT control parameter");
+    sendTextMessage(400, MSG_MISSING_PARAMETER);
+    LOG_W(LOG_MQTT_CONTROL_MISSING);
   }
 }
 
+// 格式化本机IP和MAC地址 / Format the local IP and MAC addresses
+void formatDeviceAddresses(char (&ip)[16], char (&mac)[18]) {
+  IPAddress addr = WiFi.localIP();
+  uint8_t macBytes[6];
+  WiFi.macAddress(macBytes);
+  snprintf(ip, sizeof(ip), "%u.%u.%u.%u", addr[0], addr[1], addr[2], addr[3]);
+  snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X",
+           macBytes[0], macBytes[1], macBytes[2], macBytes[3], macBytes[4], macBytes[5]);
+}
+
 // 处理设备信息请求 / Handle device info request
 void handleDeviceInfo() {
-  String deviceInfo = "{";
-  deviceInfo += "\"ip\":\"" + WiFi.localIP().toString() + "\",";
-  deviceInfo += "\"mac\":\"" + WiFi.macAddress() + "\",";
-  deviceInfo += "\"version\":\"" + String(FIRMWARE_VERSION) + "\",";
-  deviceInfo += "\"onlineClients\":" + String(clients.size());
-  deviceInfo += "}";
-  server.send(200, "application/json", deviceInfo);
+  char ip[16];
+  char mac[18];
+  formatDeviceAddresses(ip, mac);
+  PayloadWriter out;
+  out.beginObject()
+      .field(F("ip"), ip)
+      .field(F("mac"), mac)
+      .field(F("version"), FIRMWARE_VERSION)
+      .field(F("onlineClients"), (unsigned)clients.size())
+      .endObject();
+  out.send();
+}
+
+// =============================
+// 设备完整状态 / Full device state
+// =============================
+// /api/state 一次返回全部设置和运行状态，并带一个代数：主循环每轮比较状态快照，有任何变化代数加一。代数同时作为
+// ETag，轮询方带 If-None-Match 请求时，状态未变只回空的 304。电机位置运行中持续变化，不计入状态，避免代数不停增长。
+// /api/state returns every setting and the run state in one response, together with a generation: the loop compares a
+// state snapshot every pass and bumps the generation on any change. The generation doubles as the ETag, so a poller
+// sending If-None-Match gets an empty 304 while nothing changed. The motor position changes constantly while running and
+// is left out, so the generation does not tick all the time.
+struct DeviceState {
+  bool enabled;
+  bool forward;
+  unsigned int stepInterval;
+  int microstep;
+  unsigned long runDuration;
+  bool mqttControl;
+  unsigned long clientsVersion;
+  WiFiBringupState wifi;
+};
+
+DeviceState stateLastSnapshot = {}; // 上次比较的状态 / State at the last comparison
+unsigned long stateGeneration = 0; // 状态代数，首次比较后为1 / State generation, 1 after the first comparison
+// 每次启动取一个随机纪元，重启后代数从头计数也不会与旧 ETag 相同 / Random epoch picked at every boot, so a generation
+// counted again from the start after a reboot never repeats an old ETag
+uint32_t stateEpoch = 0;
+
+void beginStateEpoch() {
+  stateEpoch = ESP.random();
+}
+
+DeviceState captureDeviceState() {
+  return {motorEnabled, motorDirection, stepInterval, currentMicrostep, motorRunDuration, mqttControlEnabled,
+          clientsVersion, wifiState};
+}
+
+bool sameDeviceState(const DeviceState& a, const DeviceState& b) {
+  return a.enabled == b.enabled && a.forward == b.forward && a.stepInterval == b.stepInterval &&
+         a.microstep == b.microstep && a.runDuration == b.runDuration && a.mqttControl == b.mqttControl &&
+         a.clientsVersion == b.clientsVersion && a.wifi == b.wifi;
+}
+
+void updateStateGeneration() {
+  DeviceState state = captureDeviceState();
+  if (sameDeviceState(state, stateLastSnapshot)) return;
+  stateLastSnapshot = state;
+  stateGeneration++;
+}
+
+// If-None-Match 是否等于当前纪元和代数（接受 "e-5"、W/"e-5" 和 e-5） / Whether If-None-Match names the current epoch
+// and generation ("e-5", W/"e-5" or e-5)
+bool stateGenerationMatches(const String& tag) {
+  const char* p = tag.c_str();
+  if (p[0] == 'W' && p[1] == '/') p += 2;
+  if (*p == '"') p++;
+  char* end;
+  unsigned long epoch = strtoul(p, &end, 16);
+  if (end == p || *end != '-') return false;
+  p = end + 1;
+  unsigned long generation = strtoul(p, &end, 10);
+  return end != p && (*end == '\0' || *end == '"') && epoch == stateEpoch && generation == stateGeneration;
+}
+
+// 处理设备完整状态请求 / Handle full device state request
+void handleState() {
+  updateStateGeneration(); // 本轮主循环中刚发生的变化也计入 / Count changes made earlier in this loop pass
+  char etag[24];
+  snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)stateEpoch, stateGeneration);
+  server.sendHeader("ETag", etag);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (stateGenerationMatches(server.header("If-None-Match"))) {
+    server.send(304);
+    return;
+  }
+  char ip[16];
+  char mac[18];
+  formatDeviceAddresses(ip, mac);
+  PayloadWriter out;
+  out.beginObject()
+      .field(F("generation"), stateGeneration)
+      .field(F("enabled"), motorEnabled)
+      .field(F("direction"), motorDirection ? F("forward") : F("reverse"))
+      .field(F("stepIntervalUs"), stepInterval)
+      .field(F("microstep"), currentMicrostep)
+      .field(F("runDurationS"), motorRunDuration / 1000)
+      .field(F("mqttControl"), mqttControlEnabled)
+      .field(F("wifiConnected"), wifiState == WIFI_STATE_CONNECTED)
+      .field(F("ip"), ip)
+      .field(F("mac"), mac)
+      .field(F("version"), FIRMWARE_VERSION)
+      .field(F("onlineClients"), (unsigned)clients.size())
+      .endObject();
+  out.send();
 }
 
 // 处理设置电机启动时长的网页请求 / Handle web request to set motor run duration
 void handleSetMotorRunDuration() {
-  if (server.hasArg("duration")) {
-    int duration = server.arg("duration").toInt();
+  String durationArg = requestArg(PSTR("duration"));
+  if (durationArg.length() > 0) {
+    int duration = durationArg.toInt();
     if (duration >= 1 && duration <= 1800) { // 范围：1秒到30分钟 / Range: 1 second to 30 minutes
       motorRunDuration = duration * 1000; // 转换为毫秒 / Convert to milliseconds
-      server.send(200, "text/plain; charset=utf-8", "电机启动时长已更新 / Motor run duration updated");
-      Serial.printf("电机启动时长设置为: %d 秒 / Motor run duration set to: %d seconds\n", duration, duration);
+      sendTextMessage(200, MSG_RUN_DURATION_UPDATED);
+      LOG_I(LOG_RUN_DURATION_SET, duration);
     } else {
-      server.send(400, "text/plain; charset=utf-8", "无效的时长，范围为1到1800秒 / Invalid duration, range is 1 to 1800 seconds");
-      Serial.println("设置电机启动时长失败：无效的时长 / Failed to set motor run duration: Invalid duration");
+      sendTextMessage(400, MSG_INVALID_DURATION);
+      LOG_W(LOG_RUN_DURATION_INVALID);
     }
   } else {
-    server.send(400, "text/plain; charset=utf-8", "缺少时长参数 / Missing duration parameter");
-    Serial.println("设置电机启动时长失败：缺少时长参数 / Failed to set motor run duration: Missing duration parameter");
+    sendTextMessage(400, MSG_MISSING_DURATION);
+    LOG_W(LOG_RUN_DURATION_MISSING);
   }
 }
 
 // 处理控制端信息页面请求 / Handle client info page request
 void handleClientsPage() {
-  String html = R"rawliteral(
-    <!DOCTYPE html>
-    <html>
-    <head>
-      <meta charset="UTF-8">
-      <title>控制端设备信息</title>
-      <style>
-        body { font-family: Arial, sans-serif; text-align: center; margin: 20px; }
-        table { margin: 20px auto; border-collapse: collapse; width: 80%; }
-        th, td { border: 1px solid #ddd; padding: 8px; text-align: center; }
-        th { background-color: #4CAF50; color: white; }
-        tr:nth-child(even) { background-color: #f2f2f2; }
-        tr:hover { background-color: #ddd; }
-        .back-button {
-          margin-top: 20px;
-          padding: 10px 20px;
-          font-size: 16px;
-          color: white;
-          background-color: #4CAF50;
-          border: none;
-          border-radius: 5px;
-          box-shadow: 0 4px 6px rgba(0, 0, 0, 0.1);
-          cursor: pointer;
-          transition: background-color 0.3s, box-shadow 0.3s;
-        }
-        .back-button:hover {
-          background-color: #45a049;
-          box-shadow: 0 6px 8px rgba(0, 0, 0, 0.15);
-        }
-      </style>
-    </head>
-    <body>
-      <h1>控制端设备信息</h1>
-      <table>
-        <tr>
-          <th>设备名称</th>
-          <th>MAC 地址</th>
-        </tr>
-  )rawliteral";
+  sendWebAsset(WEB_ASSET_CLIENTS);
+}
 
-  // 遍历控制端信息并生成表格行 / Iterate over clients and generate table rows
-  for (const auto& client : clients) {
-    html += "<tr><td>" + client.second + "</td><td>" + client.first + "</td></tr>";
+// 控制端列表分页 / Client list paging
+#define CLIENTS_PAGE_DEFAULT 20 // 未指定 limit 时每页条数 / Page size when no limit is given
+#define CLIENTS_PAGE_MAX 100 // 每页最多条数 / Max entries per page
+
+// 处理控制端列表请求：按 offset/limit 返回一页，总数放在 X-Total-Count 响应头中。条目直接从登记表写入固定的
+// 发送缓冲区，内存占用与控制端数量无关。
+// Handle client list request: return one page selected by offset/limit, with the total in the X-Total-Count header.
+// Entries go straight from the registry into the fixed send buffer, so memory use does not depend on the client count.
+void handleClientsList() {
+  long offset = server.hasArg("offset") ? server.arg("offset").toInt() : 0;
+  long limit = server.hasArg("limit") ? server.arg("limit").toInt() : CLIENTS_PAGE_DEFAULT;
+  if (offset < 0) offset = 0;
+  if (limit < 1) limit = 1;
+  if (limit > CLIENTS_PAGE_MAX) limit = CLIENTS_PAGE_MAX;
+
+  char total[12];
+  snprintf(total, sizeof(total), "%u", (unsigned)clients.size());
+  server.sendHeader("X-Total-Count", total);
+  PayloadWriter out;
+  out.beginArray();
+  auto it = clients.begin();
+  for (long i = 0; i < offset && it != clients.end(); i++) ++it;
+  for (long n = 0; n < limit && it != clients.end(); n++, ++it) {
+    out.beginObject().field(F("mac"), it->first).field(F("name"), it->second).endObject();
   }
-
-  html += R"rawliteral(
-      </table>
-      <button class="back-button" onclick="location.href='/'">返回主页面</button>
-    </body>
-    </html>
-  )rawliteral";
-
-  server.send(200, "text/html", html);
+  out.endArray();
+  out.send();
 }
 
 // 处理设置控制端名称的请求 / Handle set client name request
@@ -1388,10 +3428,11 @@ void handleSetClientName() {
     String mac = server.arg("mac");
     String name = server.arg("name");
     clients[mac] = name; // 更新或添加控制端信息 / Update or add client info
-    server.send(200, "text/plain", "控制端名称已更新 / Client name updated");
-    Serial.printf("控制端名称已更新: MAC=%s, 名称=%s\n", mac.c_str(), name.c_str());
+    clientsVersion++;
+    sendTextMessage(200, MSG_CLIENT_NAME_UPDATED);
+    LOG_I(LOG_CLIENT_NAME_UPDATED, mac, name);
   } else {
-    server.send(400, "text/plain", "缺少参数 / Missing parameters");
+    sendTextMessage(400, MSG_MISSING_PARAMETER);
   }
 }
 
@@ -1399,52 +3440,288 @@ void handleSetClientName() {
 void updateClientOnlineStatus(String mac) {
   if (clients.find(mac) == clients.end()) {
     clients[mac] = "默认名称"; // 如果未设置名称，使用默认名称 / Use default name if not set
+    clientsVersion++;
   }
-  Serial.printf("控制端在线: MAC=%s\n", mac.c_str());
+  LOG_D(LOG_CLIENT_ONLINE, mac);
 }
 
 // 处理重新配网请求 / Handle reset WiFi request
 void handleResetWiFi() {
-  Serial.println("收到重新配网请求，准备进入智能配网模式 / Received reset WiFi request, preparing to enter smart configuration mode");
-  server.send(200, "text/plain; charset=utf-8", "设备正在重新进入配网模式，请稍候... / Device is restarting to enter configuration mode, please wait...");
+  LOG_I(LOG_RESET_WIFI_REQUEST);
+  sendTextMessage(200, MSG_RESET_WIFI);
   delay(1000); // 延迟以确保响应发送完成 / Delay to ensure the response is sent
   WiFi.disconnect(); // 断开WiFi连接 / Disconnect WiFi
-  Serial.println("WiFi已断开，设备即将重启 / WiFi disconnected, device will restart");
+  LOG_I(LOG_RESET_WIFI_RESTART);
+  logFlush(); // 重启前输出全部日志 / Flush all logs before restarting
   ESP.restart(); // 重启设备以进入智能配网模式 / Restart device to enter smart configuration mode
 }
 
 // 新增API：设置细分模式
 void handleSetMicrostep() {
-    if (server.hasArg("mode")) {
-        int mode = server.arg("mode").toInt();
+    String modeArg = requestArg(PSTR("mode"));
+    if (modeArg.length() > 0) {
+        int mode = modeArg.toInt();
         if (mode == MICROSTEP_FULL || mode == MICROSTEP_8 || mode == MICROSTEP_16 || mode == MICROSTEP_32) {
             setMicrostepMode(mode);
-            server.send(200, "text/plain; charset=utf-8", "细分模式已切换");
+            sendTextMessage(200, MSG_MICROSTEP_CHANGED);
         } else {
-            server.send(400, "text/plain; charset=utf-8", "无效细分模式");
+            sendTextMessage(400, MSG_INVALID_MICROSTEP);
         }
     } else {
-        server.send(400, "text/plain; charset=utf-8", "缺少参数");
+        sendTextMessage(400, MSG_MISSING_PARAMETER);
     }
 }
 
 // 新增API：获取当前细分模式
 void handleGetMicrostep() {
-    String json = "{\"mode\":" + String(currentMicrostep) + "}";
-    server.send(200, "application/json", json);
+    PayloadWriter out;
+    out.beginObject().field(F("mode"), currentMicrostep).endObject();
+    out.send();
 }
 
 // 新增单步运行接口，便于调试和外部调用
 void handleStepOnce() {
     stepMotorOnce();
-    server.send(200, "text/plain; charset=utf-8", "单步运行已执行 / Step motor once executed");
+    sendTextMessage(200, MSG_STEP_ONCE);
 }
 
 // 新增API接口：单步运行（API风格，支持GET/POST）
 void handleApiStepOnce() {
     stepMotorOnce();
-    server.send(200, "application/json", "{\"result\":true,\"msg\":\"step once ok\"}");
+    PayloadWriter out;
+    out.beginObject().field(F("result"), true).field(F("msg"), F("step once ok")).endObject();
+    out.send();
+}
+
+// 批量控制命令 / Batch control commands
+#define BATCH_MAX_COMMANDS 16 // 每批最多命令数 / Max commands per batch
+
+// 处理批量控制命令：命令用换行、分号或逗号分隔，语法与WebSocket控制帧相同；请求体也可以是由命令文本组成的 CBOR
+// 数组。全部校验通过后在同一次处理中依次执行，中间不会插入主循环的其他工作；任何一条无效则全部不执行。
+// Handle a command batch: commands are separated by newlines, semicolons or commas and use the WebSocket frame syntax;
+// the body may also be a CBOR array of command strings. Once every command validates they are applied back to back in
+// one pass, with no other loop work in between; if any is invalid nothing is applied.
+void handleBatch() {
+  ControlCommand commands[BATCH_MAX_COMMANDS];
+  char texts[BATCH_MAX_COMMANDS][WS_COMMAND_MAX_LENGTH + 1];
+  bool valid[BATCH_MAX_COMMANDS];
+  int count = 0;
+  int firstInvalid = -1;
+  bool tooMany = false;
+  auto addCommand = [&](const char* p, size_t len) {
+    if (count == BATCH_MAX_COMMANDS) {
+      tooMany = true;
+      return;
+    }
+    size_t copied = len < WS_COMMAND_MAX_LENGTH ? len : WS_COMMAND_MAX_LENGTH;
+    memcpy(texts[count], p, copied);
+    texts[count][copied] = '\0';
+    valid[count] = len <= WS_COMMAND_MAX_LENGTH && parseControlCommand(p, len, commands[count]);
+    if (!valid[count] && firstInvalid < 0) firstInvalid = count;
+    count++;
+  };
+
+  size_t rawLength;
+  const uint8_t* raw = server.rawBody(rawLength);
+  TextMessageId malformed = TEXT_MESSAGE_COUNT; // CBOR 格式错误时的回复 / Reply for malformed CBOR
+  if (!server.hasArg("cmds") && raw && isCborContainer(raw, rawLength)) {
+    CborReader reader(raw, rawLength);
+    uint8_t major;
+    unsigned long long items;
+    bool indefinite;
+    if (!reader.readHead(major, items, indefinite) || major != CBOR_ARRAY) {
+      malformed = MSG_MISSING_COMMAND;
+    }
+    while (malformed == TEXT_MESSAGE_COUNT && !tooMany && (indefinite ? !reader.readBreak() : items-- > 0)) {
+      const char* text;
+      size_t len;
+      if (!reader.readText(text, len)) {
+        malformed = MSG_UNKNOWN_COMMAND;
+        break;
+      }
+      addCommand(text, len);
+    }
+  } else {
+    String body = server.hasArg("cmds") ? server.arg("cmds") : server.arg("plain"); // 表单字段或原始请求体 / Form field or raw body
+    const char* p = body.c_str();
+    const char* end = p + body.length();
+    auto isSeparator = [](char c) { return c == '\n' || c == '\r' || c == ';' || c == ',' || c == ' ' || c == '\t'; };
+    while (p < end && !tooMany) {
+      while (p < end && isSeparator(*p)) p++;
+      if (p >= end) break;
+      const char* q = p;
+      while (q < end && !isSeparator(*q)) q++;
+      addCommand(p, q - p);
+      p = q;
+    }
+  }
+  // 含有效 off 命令的批量请求优先放行，其余先扣令牌再回复 / A batch with a valid off is admitted with priority; any
+  // other is charged before it gets a reply
+  bool stop = false;
+  for (int i = 0; i < count; i++) {
+    if (valid[i] && commands[i].op == CMD_OFF) stop = true;
+  }
+  if (!admitParsedRequest(stop)) return;
+  if (malformed != TEXT_MESSAGE_COUNT) {
+    sendTextMessage(400, malformed);
+    return;
+  }
+  if (tooMany) {
+    sendTextMessage(400, MSG_TOO_MANY_COMMANDS);
+    return;
+  }
+  if (count == 0) {
+    sendTextMessage(400, MSG_MISSING_COMMAND);
+    return;
+  }
+
+  bool applied = firstInvalid < 0;
+  if (applied) {
+    for (int i = 0; i < count; i++) applyControlCommand(commands[i]);
+    LOG_I(LOG_BATCH_APPLIED, count);
+  } else {
+    LOG_W(LOG_BATCH_REJECTED, firstInvalid + 1);
+  }
+
+  PayloadWriter out(applied ? 200 : 400);
+  out.beginObject().field(F("applied"), applied);
+  out.key(F("results")).beginArray();
+  for (int i = 0; i < count; i++) {
+    out.beginObject().field(F("cmd"), (const char*)texts[i]).field(F("ok"), valid[i]).endObject();
+  }
+  out.endArray();
+  out.key(F("state")).beginObject()
+      .field(F("enabled"), motorEnabled)
+      .field(F("direction"), motorDirection ? F("forward") : F("reverse"))
+      .field(F("stepIntervalUs"), stepInterval)
+      .field(F("microstep"), currentMicrostep)
+      .field(F("position"), motorPosition)
+      .field(F("stepsRemaining"), motorStepsRemaining)
+      .endObject();
+  out.endObject();
+  out.send();
 }
 
+#ifdef HTTP_SERVER_PROFILE
+// 处理路由统计请求：列出被调用过的路由的耗时和堆占用，带 reset=1 时返回后清零
+// Handle route statistics request: list time and heap use of every route called so far; reset=1 clears them afterwards
+void handleRouteStats() {
+  PayloadWriter out;
+  out.beginObject().field(F("freeHeap"), ESP.getFreeHeap());
+  out.key(F("routes")).beginArray();
+  for (size_t i = 0; i < server.routeCount() && i < HTTP_SERVER_PROFILE_ROUTES; i++) {
+    const HttpServer::RouteProfile& p = server.routeProfile(i);
+    if (p.calls == 0) continue;
+    out.beginObject()
+        .field(F("uri"), server.routeUri(i))
+        .field(F("calls"), p.calls)
+        .field(F("avgUs"), p.totalUs / p.calls)
+        .field(F("maxUs"), p.maxUs)
+        .field(F("heapPeak"), p.heapPeak)
+        .field(F("heapHeld"), (long)p.heapHeld)
+        .endObject();
+  }
+  out.endArray().endObject();
+  out.send();
+  if (server.arg("reset") == "1") server.resetProfiles();
+}
+#endif
+
+// 处理运行指标请求 / Handle runtime metrics request
+void handleMetrics() {
+  unsigned long uptimeMs = millis();
+  unsigned long sleepMs = (unsigned long)(idleSleepMicros / 1000);
+  // 占空比：清醒时间占总运行时间的千分比 / Duty cycle: awake time in per-mille of uptime
+  unsigned long dutyPermille = uptimeMs > 0 ? 1000 - (unsigned long)((unsigned long long)sleepMs * 1000 / uptimeMs) : 1000;
+  PayloadWriter out;
+  out.beginObject().field(F("uptimeMs"), uptimeMs);
+  out.key(F("idle")).beginObject()
+      .field(F("active"), idleModeActive)
+      .field(F("entries"), idleEnterCount)
+      .field(F("sleepMs"), sleepMs)
+      .field(F("dutyCyclePermille"), dutyPermille)
+      .endObject();
+  out.key(F("wifi")).beginObject()
+      .field(F("connected"), wifiState == WIFI_STATE_CONNECTED)
+      .field(F("timeToConnectMs"), wifiTimeToConnect)
+      .field(F("lastConnectFast"), wifiLastConnectWasFast)
+      .field(F("cachedIp"), wifiUsingCachedIp)
+      .field(F("fastConnectAttempts"), wifiFastConnectAttempts)
+      .field(F("fastConnectSuccesses"), wifiFastConnectSuccesses)
+      .endObject();
+  out.key(F("loop")).beginObject()
+      .field(F("count"), loopCount)
+      .field(F("avgUs"), loopCount > 0 ? (unsigned long)(loopWorkMicros / loopCount) : 0UL)
+      .field(F("maxUs"), loopWorkMaxMicros)
+      .endObject();
+  const HttpServer::Stats& http = server.stats();
+  out.key(F("http")).beginObject()
+      .field(F("open"), server.openConnections())
+      .field(F("accepted"), http.accepted)
+      .field(F("rejected"), http.rejected)
+      .field(F("evicted"), http.evicted)
+      .field(F("idleClosed"), http.idleClosed)
+      .field(F("requests"), http.requests)
+      .field(F("reused"), http.reused)
+      .field(F("throttled"), http.throttled)
+      .endObject();
+  out.key(F("rateLimit")).beginObject()
+      .field(F("perIp"), rateLimitedPerIp)
+      .field(F("global"), rateLimitedGlobal)
+      .field(F("priority"), priorityAdmitted)
+      .endObject();
+  out.key(F("log")).beginObject()
+      .field(F("level"), LOG_LEVEL)
+      .field(F("queued"), logCount)
+      .field(F("written"), logWritten)
+      .field(F("dropped"), logDropped)
+      .endObject();
+  out.endObject();
+  out.send();
+}
 
+// 处理启动阶段耗时请求 / Handle boot phase timing request
+void handleBootTiming() {
+  PayloadWriter out;
+  out.beginObject().key(F("phases")).beginObject();
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    out.key(BOOT_PHASE_NAMES[i]);
+    // 未到达的阶段返回null / Phases not reached yet are null
+    if (bootPhaseTimes[i]) {
+      out.value((unsigned long long)bootPhaseTimes[i]);
+    } else {
+      out.nullValue();
+    }
+  }
+  out.endObject().field(F("unit"), F("us")).endObject();
+  out.send();
+}
 
+// 处理卡顿记录请求，按时间从旧到新输出 / Handle stall records request, oldest first
+void handleStalls() {
+  PayloadWriter out;
+  out.beginObject()
+      .field(F("thresholdMs"), stallThresholdMs)
+      .field(F("boot"), stallLog->bootCount)
+      .field(F("detected"), stallDetectedCount);
+  out.key(F("stalls")).beginArray();
+  uint32_t count = stallLog->count;
+  for (uint32_t i = 0; i < count; i++) {
+    volatile StallRecord& rec = stallLog->records[(stallLog->head + STALL_RING_SIZE - count + i) % STALL_RING_SIZE];
+    out.beginObject()
+        .field(F("boot"), rec.boot)
+        .field(F("subsystem"), rec.subsystem < STALL_SUBSYSTEM_COUNT ? STALL_SUBSYSTEM_NAMES[rec.subsystem] : "unknown")
+        .field(F("uptimeMs"), rec.uptimeMs)
+        .field(F("durationMs"), rec.durationMs)
+        .field(F("reset"), rec.open != 0);
+    out.key(F("pc")).beginArray();
+    for (int k = 0; k < STALL_PC_SAMPLES && rec.pc[k] != 0; k++) {
+      char pc[11];
+      snprintf(pc, sizeof(pc), "0x%08x", (unsigned)rec.pc[k]);
+      out.value(pc);
+    }
+    out.endArray().endObject();
+  }
+  out.endArray().endObject();
+  out.send();
+}
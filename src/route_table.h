@@ -0,0 +1,159 @@
+// 编译期完美哈希路由表 / Compile-time perfect-hash route table
+//
+// 路由在编译期写成常量数组，constexpr 构造函数用 CHD 方法为这组 URI 生成完美哈希：先把 URI 哈希到若干个桶，
+// 再从最大的桶开始，为每个桶单独搜索一个种子，使桶内每个 URI 都落在空闲的槽位。每个桶只有一两个 URI，种子很快
+// 找到，构造时间与路由数量成线性关系。运行时查找对请求路径计算两次哈希（桶、槽位）、读一个槽位、做一次字符串
+// 比较，与路由数量无关，也不分配 String。表、桶种子和槽位数组都是编译期常量；URI 重复或找不到种子时编译失败。
+//
+// Routes are written as a constant array at compile time, and a constexpr constructor builds a perfect hash for the
+// URI set with CHD: URIs are hashed into buckets, then, largest bucket first, each bucket gets its own seed that puts
+// every URI of the bucket in a free slot. Buckets hold one or two URIs, so seeds are found quickly and construction is
+// linear in the number of routes. A runtime lookup hashes the request path twice (bucket, slot), reads one slot and
+// does one string compare, independent of the number of routes and without allocating a String.
+// The table, bucket seeds and slot array are compile-time constants; a duplicate URI or a failed seed search fails
+// the build.
+#pragma once
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h> // HTTPMethod
+
+// 路由表的一项 / One route table entry
+struct HttpRoute {
+  const char* uri;
+  HTTPMethod method;
+  void (*handler)();
+  void (*uploadHandler)(); // 可为 nullptr / May be nullptr
+};
+
+#define HTTP_ROUTE_SEED_LIMIT 65535 // 每个桶最多尝试的种子数 / Max seeds tried per bucket
+
+// 带种子的 FNV-1a，编译期和运行时共用；种子0用于分桶，1起用于槽位 / Seeded FNV-1a, shared by compile time and runtime;
+// seed 0 picks the bucket, seeds from 1 pick the slot
+constexpr uint32_t httpRouteHash(const char* s, uint32_t seed) {
+  uint32_t h = 2166136261u ^ seed;
+  while (*s) {
+    h ^= (uint8_t)*s++;
+    h *= 16777619u;
+  }
+  return h ^ (h >> 15);
+}
+
+constexpr size_t httpRouteBucket(const char* uri, size_t mask) {
+  return (httpRouteHash(uri, 0) >> 16) & mask;
+}
+
+constexpr bool httpRouteUriEquals(const char* a, const char* b) {
+  while (*a && *a == *b) {
+    a++;
+    b++;
+  }
+  return *a == *b;
+}
+
+// 不小于 minimum 的 2 的幂 / Power of two at or above minimum
+constexpr size_t httpRouteSlotCount(size_t minimum) {
+  size_t n = 1;
+  while (n < minimum) n <<= 1;
+  return n;
+}
+
+// 未定义：常量求值中调用即编译失败 / Left undefined: reaching it during constant evaluation fails the build
+void httpRouteTableError(const char* reason);
+
+// 运行时使用的表视图，与路由数量无关 / Runtime view of a table, independent of the route count
+struct HttpRouteIndex {
+  const HttpRoute* routes = nullptr;
+  const uint8_t* slots = nullptr; // 路由下标加一，0 表示空槽 / Route index plus one, 0 for an empty slot
+  const uint16_t* seeds = nullptr; // 每个桶的槽位种子 / Slot seed of each bucket
+  uint8_t count = 0;
+  uint8_t slotMask = 0;
+  uint8_t bucketMask = 0;
+
+  // 按路径查找，未找到返回 -1 / Look a path up; -1 when absent
+  int find(const char* uri) const {
+    if (!slots) return -1;
+    uint16_t seed = seeds[httpRouteBucket(uri, bucketMask)];
+    uint8_t slot = slots[httpRouteHash(uri, seed) & slotMask];
+    if (slot == 0) return -1;
+    return strcmp(routes[slot - 1].uri, uri) == 0 ? slot - 1 : -1;
+  }
+};
+
+template <size_t N>
+class HttpRouteTable {
+public:
+  static_assert(N > 0 && N < 128, "route count must be 1..127");
+
+  // 槽位数取不小于 2N 的 2 的幂，平均每个桶两个 URI / Slot count is the power of two at or above 2N; buckets average
+  // two URIs
+  static constexpr size_t SLOTS = httpRouteSlotCount(2 * N);
+  static constexpr size_t BUCKETS = httpRouteSlotCount((N + 1) / 2);
+
+  constexpr HttpRouteTable(const HttpRoute (&routes)[N]) : _routes(routes) {
+    for (size_t i = 0; i < N; i++) {
+      for (size_t j = i + 1; j < N; j++) {
+        if (httpRouteUriEquals(routes[i].uri, routes[j].uri)) httpRouteTableError("duplicate route uri");
+      }
+    }
+    size_t bucketOf[N] = {};
+    size_t bucketSize[BUCKETS] = {};
+    size_t largest = 0;
+    for (size_t i = 0; i < N; i++) {
+      bucketOf[i] = httpRouteBucket(routes[i].uri, BUCKETS - 1);
+      if (++bucketSize[bucketOf[i]] > largest) largest = bucketSize[bucketOf[i]];
+    }
+    // 大桶先放，此时空槽最多 / Place large buckets first, while free slots are plentiful
+    for (size_t size = largest; size > 0; size--) {
+      for (size_t b = 0; b < BUCKETS; b++) {
+        if (bucketSize[b] == size) placeBucket(b, bucketOf);
+      }
+    }
+  }
+
+  HttpRouteIndex index() const {
+    HttpRouteIndex idx;
+    idx.routes = _routes;
+    idx.slots = _slots;
+    idx.seeds = _seeds;
+    idx.count = N;
+    idx.slotMask = SLOTS - 1;
+    idx.bucketMask = BUCKETS - 1;
+    return idx;
+  }
+
+private:
+  const HttpRoute* _routes;
+  uint8_t _slots[SLOTS] = {};
+  uint16_t _seeds[BUCKETS] = {};
+
+  // 为一个桶找到把全部成员放进空槽的种子 / Find a seed that puts every member of a bucket in a free slot
+  constexpr void placeBucket(size_t bucket, const size_t (&bucketOf)[N]) {
+    size_t members[N] = {};
+    size_t count = 0;
+    for (size_t i = 0; i < N; i++) {
+      if (bucketOf[i] == bucket) members[count++] = i;
+    }
+    size_t taken[N] = {};
+    for (uint32_t seed = 1; seed <= HTTP_ROUTE_SEED_LIMIT; seed++) {
+      bool fits = true;
+      for (size_t k = 0; k < count && fits; k++) {
+        taken[k] = httpRouteHash(_routes[members[k]].uri, seed) & (SLOTS - 1);
+        if (_slots[taken[k]] != 0) fits = false;
+        for (size_t m = 0; m < k && fits; m++) {
+          if (taken[m] == taken[k]) fits = false;
+        }
+      }
+      if (!fits) continue;
+      for (size_t k = 0; k < count; k++) _slots[taken[k]] = members[k] + 1;
+      _seeds[bucket] = seed;
+      return;
+    }
+    httpRouteTableError("no perfect hash seed found for a bucket");
+  }
+};
+
+// 从路由数组推导表大小 / Deduce the table size from the route array
+template <size_t N>
+constexpr HttpRouteTable<N> makeHttpRouteTable(const HttpRoute (&routes)[N]) {
+  return HttpRouteTable<N>(routes);
+}
@@ -0,0 +1,344 @@
+// 由 scripts/build_web_assets.py 根据 web/ 目录生成，请勿手动修改
+// Generated by scripts/build_web_assets.py from web/, do not edit
+#pragma once
+
+#include <Arduino.h>
+
+struct WebAsset {
+  const char* path; // 请求路径 / Request path
+  const char* contentType;
+  const uint8_t* data; // gzip 压缩后的内容（PROGMEM） / Gzipped content (PROGMEM)
+  size_t length;
+  const char* etag; // 内容哈希，带引号 / Content hash, quoted
+};
+
+// index.html: 9172 -> 2945 字节 / bytes
+static const uint8_t WEB_ASSET_INDEX_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xe5, 0x5a, 0x6d, 0x73, 0xd4, 0xd6,
+  0x15, 0xfe, 0xce, 0xaf, 0xb8, 0xa8, 0x4c, 0x76, 0xb7, 0xb5, 0x77, 0xbd, 0x76, 0x60, 0xdc, 0x7d,
+  0x63, 0xa8, 0x0d, 0x13, 0x77, 0xe2, 0xd8, 0xc5, 0x66, 0x32, 0x9d, 0x4e, 0xc6, 0x96, 0xa5, 0xbb,
+  0x5e, 0x05, 0xad, 0xa4, 0x48, 0x5a, 0x16, 0xd7, 0xb3, 0x33, 0x66, 0x5a, 0x62, 0xf3, 0x62, 0x0c,
+  0x09, 0x84, 0x16, 0x5c, 0x5e, 0x02, 0x04, 0x97, 0x80, 0x4d, 0x0a, 0x25, 0xa9, 0xb1, 0xf1, 0x9f,
+  0xb1, 0xb4, 0xde, 0x4f, 0xfe, 0x0b, 0x39, 0xf7, 0x45, 0x5a, 0x69, 0x5f, 0xcc, 0x9a, 0x61, 0xd2,
+  0xce, 0x94, 0x2f, 0xd6, 0xde, 0x7b, 0xf5, 0xdc, 0x73, 0xce, 0x7d, 0xce, 0xb9, 0xe7, 0x1c, 0x91,
+  0x39, 0x38, 0x38, 0x32, 0x30, 0xfe, 0xc7, 0xd1, 0xe3, 0xa8, 0x60, 0x17, 0xd5, 0xdc, 0x81, 0x8c,
+  0xf7, 0x07, 0x8b, 0x72, 0xee, 0x00, 0x42, 0x99, 0x22, 0xb6, 0x45, 0x24, 0x15, 0x44, 0xd3, 0xc2,
+  0x76, 0x56, 0x38, 0x35, 0x7e, 0xa2, 0xbb, 0x5f, 0xa0, 0x13, 0xb6, 0x62, 0xab, 0x38, 0x77, 0x7c,
+  0x6c, 0xb4, 0xbf, 0xf7, 0xc8, 0x11, 0xe4, 0x3e, 0x7b, 0xb4, 0xb3, 0x75, 0xbb, 0x7a, 0xfd, 0xdf,
+  0xee, 0xf2, 0xba, 0x7b, 0xe5, 0xb1, 0xb3, 0xf0, 0xaa, 0xfa, 0xe2, 0x75, 0xf5, 0xf5, 0xdd, 0x4c,
+  0x82, 0xad, 0x23, 0x6f, 0x58, 0xf6, 0x0c, 0x7b, 0x42, 0x68, 0x4a, 0x97, 0x67, 0xd0, 0x2c, 0xca,
+  0xeb, 0x9a, 0xdd, 0x9d, 0x17, 0x8b, 0x8a, 0x3a, 0x93, 0x42, 0xc7, 0x4c, 0x45, 0x54, 0xbb, 0x90,
+  0x25, 0x6a, 0x56, 0xb7, 0x85, 0x4d, 0x25, 0x9f, 0x46, 0x36, 0x3e, 0x6b, 0x77, 0x8b, 0xaa, 0x32,
+  0xad, 0xa5, 0x90, 0x84, 0x35, 0x1b, 0x9b, 0x69, 0x54, 0x14, 0xcd, 0x69, 0x05, 0x7e, 0xf7, 0xf6,
+  0x18, 0x67, 0xd3, 0xa8, 0x42, 0xe1, 0x0a, 0x49, 0x00, 0x93, 0x74, 0x55, 0x37, 0x53, 0xe8, 0x57,
+  0x7d, 0x7d, 0x7d, 0xde, 0xf8, 0x54, 0xc9, 0xb6, 0x75, 0xad, 0x0b, 0x29, 0x9a, 0x51, 0xb2, 0xff,
+  0x64, 0xcf, 0x18, 0x38, 0x2b, 0x10, 0x4c, 0xe1, 0xb3, 0xf0, 0x98, 0x56, 0x2a, 0x4e, 0x61, 0x53,
+  0xf8, 0x0c, 0x50, 0x0c, 0x51, 0x96, 0x15, 0x6d, 0x3a, 0x85, 0x92, 0x80, 0xcf, 0x37, 0xf1, 0xb6,
+  0x4c, 0xd2, 0x5f, 0x54, 0x68, 0x4b, 0xf9, 0x33, 0x86, 0x81, 0x23, 0x75, 0x19, 0xd8, 0x5e, 0x80,
+  0x30, 0x25, 0x4a, 0xa7, 0xa7, 0x4d, 0xbd, 0xa4, 0xc9, 0xdd, 0x9e, 0x48, 0x1f, 0x0e, 0x1c, 0x3b,
+  0x71, 0xb8, 0x27, 0xed, 0x89, 0x58, 0x2e, 0x28, 0x36, 0x4e, 0x83, 0x11, 0x4c, 0x19, 0xc3, 0x4f,
+  0x4d, 0xd7, 0xe0, 0x97, 0x54, 0x32, 0x2d, 0x32, 0x69, 0xe8, 0x0a, 0x53, 0x34, 0x08, 0x9b, 0x2a,
+  0xe8, 0x67, 0xb0, 0xd9, 0x06, 0xfc, 0xb0, 0xd8, 0xf3, 0xe1, 0x6f, 0xbd, 0xf5, 0xfb, 0x50, 0xb5,
+  0xac, 0xc8, 0x76, 0x21, 0x85, 0xfa, 0x7a, 0x02, 0x96, 0x8c, 0x2b, 0x5a, 0x5e, 0x87, 0xb9, 0xb0,
+  0x95, 0x83, 0x2a, 0xf7, 0x07, 0x16, 0x33, 0xe1, 0xba, 0x89, 0x40, 0x46, 0xd3, 0x4b, 0x64, 0x4d,
+  0x26, 0xe1, 0x1f, 0x7a, 0xc6, 0x92, 0x4c, 0xc5, 0xb0, 0xd9, 0xf9, 0x27, 0x12, 0x68, 0xfb, 0xa7,
+  0x39, 0xf7, 0xe9, 0x7d, 0xe7, 0xe2, 0xbd, 0x9d, 0xcd, 0xcd, 0x9d, 0xd5, 0x37, 0xce, 0xc3, 0xf9,
+  0xed, 0xad, 0xfb, 0xee, 0xb9, 0x35, 0xe7, 0xab, 0xcb, 0xce, 0xf9, 0x95, 0xda, 0x5f, 0x56, 0x60,
+  0xb0, 0xba, 0xb9, 0x8a, 0x12, 0xe8, 0x63, 0x5d, 0x94, 0x91, 0x8c, 0xcf, 0x28, 0x12, 0x46, 0x44,
+  0x3c, 0xb3, 0x28, 0xda, 0x0a, 0x98, 0x5a, 0xd4, 0x64, 0x84, 0xc1, 0x2c, 0x33, 0x08, 0xb8, 0x69,
+  0xc3, 0xa1, 0xc1, 0x2c, 0x02, 0x5b, 0x22, 0x13, 0x7f, 0x51, 0xc2, 0x96, 0x4d, 0x77, 0xca, 0x97,
+  0x34, 0x89, 0xae, 0x56, 0x01, 0x65, 0x90, 0x82, 0x0c, 0x01, 0x46, 0x34, 0x86, 0x66, 0xe9, 0x3c,
+  0xac, 0xc0, 0xb6, 0x54, 0x88, 0x46, 0x12, 0xa2, 0xa1, 0x80, 0xb4, 0xa2, 0x8d, 0x23, 0x31, 0x3e,
+  0x03, 0x1a, 0xda, 0x05, 0xac, 0x45, 0x4d, 0x6c, 0x19, 0xba, 0x66, 0x61, 0x94, 0xcd, 0x21, 0xef,
+  0x39, 0xfe, 0xb9, 0xa5, 0x6b, 0xd1, 0x58, 0xe3, 0x52, 0x59, 0x04, 0x77, 0x81, 0x65, 0xb3, 0xfe,
+  0x38, 0x42, 0xb2, 0x2e, 0x95, 0x8a, 0xc0, 0xde, 0xf8, 0x34, 0xb6, 0x8f, 0xab, 0x98, 0x3c, 0xfe,
+  0x6e, 0x66, 0x48, 0x8e, 0x46, 0x14, 0xe3, 0x98, 0x2c, 0x03, 0xa0, 0x15, 0x89, 0x81, 0xdd, 0x35,
+  0x6c, 0x8e, 0xc3, 0x81, 0xa1, 0x2c, 0x22, 0x20, 0x71, 0xc5, 0x48, 0x77, 0x82, 0x51, 0x14, 0xa5,
+  0x3d, 0x40, 0x60, 0xb6, 0x23, 0x14, 0xb0, 0xa2, 0x05, 0x46, 0x6a, 0x05, 0xc1, 0xa7, 0x3a, 0x82,
+  0xd1, 0x35, 0x55, 0xd1, 0xf0, 0x80, 0xaa, 0xc0, 0x48, 0x4b, 0x79, 0x42, 0x0b, 0x3a, 0xd3, 0x4f,
+  0x91, 0x4c, 0xdd, 0xb2, 0xb1, 0x31, 0x86, 0x55, 0x2c, 0xd9, 0x00, 0x7a, 0x46, 0x54, 0x4b, 0xd8,
+  0x57, 0xd0, 0x9b, 0xee, 0x0c, 0x4c, 0xb7, 0x75, 0x73, 0xb0, 0x64, 0x52, 0xfe, 0x34, 0x42, 0x99,
+  0x25, 0xcd, 0x9b, 0x1a, 0xab, 0xa3, 0x55, 0x02, 0x27, 0x2c, 0x89, 0x84, 0x29, 0x40, 0x1d, 0x38,
+  0x60, 0x51, 0xc5, 0xa6, 0x1d, 0x8d, 0xb8, 0x37, 0xef, 0xb9, 0x2f, 0x6e, 0x34, 0xb3, 0x18, 0x68,
+  0x7b, 0x42, 0x54, 0x54, 0x2c, 0x23, 0x5b, 0xa7, 0xd4, 0x6b, 0x41, 0xe0, 0x48, 0x2c, 0xc6, 0xf6,
+  0xa9, 0x1c, 0xf0, 0x9c, 0x82, 0x71, 0x9e, 0x85, 0x51, 0xe7, 0xea, 0x9a, 0x73, 0x71, 0xc5, 0xbd,
+  0xf9, 0xaa, 0x76, 0x63, 0x0b, 0xe0, 0xc6, 0xb0, 0x8d, 0xa8, 0xfc, 0x08, 0x04, 0x45, 0x32, 0x97,
+  0x34, 0xcc, 0x71, 0xf0, 0x83, 0xe1, 0xa0, 0x8a, 0x01, 0x96, 0x4b, 0x40, 0x5a, 0xdb, 0x7f, 0x8d,
+  0xe8, 0xbc, 0x2f, 0x23, 0xa5, 0x43, 0xce, 0x32, 0xc9, 0x9c, 0x05, 0xdb, 0x13, 0x74, 0xf1, 0x84,
+  0x07, 0x7b, 0xd4, 0x7b, 0xc8, 0x1e, 0x9a, 0xf5, 0x1e, 0x2b, 0x93, 0x7b, 0xb9, 0x53, 0xd0, 0x4f,
+  0x94, 0x3c, 0xf2, 0xe7, 0xe2, 0xfa, 0xe9, 0x58, 0x68, 0x12, 0x79, 0x16, 0x6f, 0x36, 0x8e, 0xf3,
+  0xe3, 0xbf, 0xdc, 0xdb, 0x2f, 0xdd, 0x6f, 0x9e, 0xef, 0x6e, 0x9c, 0x03, 0x43, 0x0d, 0x37, 0x19,
+  0x09, 0x95, 0x0c, 0x38, 0x61, 0x2c, 0x1f, 0x8c, 0xc4, 0x82, 0x34, 0xa9, 0x20, 0xac, 0x82, 0x14,
+  0x2d, 0x77, 0x61, 0x07, 0xe1, 0x3c, 0xfc, 0x61, 0xe7, 0xe5, 0xa3, 0xdd, 0x8d, 0xcb, 0x3b, 0x6b,
+  0x3f, 0xba, 0x0f, 0xe6, 0xdc, 0xbb, 0x8f, 0x76, 0xde, 0x7c, 0xed, 0x9c, 0x7f, 0xe4, 0xcc, 0x6d,
+  0x84, 0x0e, 0x18, 0x2c, 0xe1, 0x6f, 0xd6, 0x85, 0x0c, 0x15, 0x8b, 0x80, 0x2b, 0x15, 0xb0, 0x74,
+  0x1a, 0x81, 0xc6, 0x2c, 0xfe, 0x22, 0x6a, 0xc7, 0x06, 0x09, 0xf6, 0x47, 0xb3, 0x9d, 0xad, 0x3b,
+  0xee, 0x95, 0x47, 0xce, 0xc2, 0x73, 0xc6, 0x34, 0x10, 0xe1, 0x94, 0x26, 0x4e, 0xa9, 0x98, 0x88,
+  0x00, 0xe7, 0xab, 0x81, 0x7f, 0x90, 0x47, 0xb2, 0x25, 0x63, 0x5b, 0x5b, 0x86, 0x0d, 0xff, 0x61,
+  0x7c, 0xdc, 0x59, 0x7e, 0xee, 0xfc, 0x63, 0x8e, 0x33, 0x8b, 0x0c, 0x20, 0x91, 0x05, 0x92, 0x66,
+  0x4e, 0xc1, 0x24, 0x0f, 0x32, 0x4d, 0x8c, 0xe2, 0xef, 0xec, 0x49, 0xa8, 0x2f, 0x6c, 0xbb, 0x1e,
+  0xa3, 0xf6, 0xa6, 0x13, 0x2c, 0x3d, 0xca, 0x21, 0x81, 0x43, 0x58, 0x93, 0x74, 0x19, 0x9f, 0x3a,
+  0x39, 0x34, 0xa0, 0x17, 0x81, 0x16, 0x80, 0x18, 0xe5, 0x93, 0xb1, 0xf7, 0x4d, 0xab, 0xba, 0x45,
+  0x1a, 0xe9, 0x14, 0xb0, 0xcc, 0x2f, 0x42, 0xa4, 0xe0, 0x86, 0xff, 0xe3, 0x64, 0x72, 0x16, 0xe6,
+  0xdd, 0xc5, 0x6f, 0x89, 0xc0, 0x2c, 0xe7, 0x03, 0x90, 0x71, 0x7d, 0x7a, 0x1a, 0x40, 0xa8, 0x12,
+  0x00, 0x63, 0x9b, 0xba, 0x1a, 0xe6, 0x93, 0x4d, 0x17, 0x90, 0xf9, 0x01, 0x36, 0x1d, 0xc5, 0x74,
+  0xdf, 0x46, 0x62, 0x95, 0x4c, 0x15, 0x48, 0xc5, 0xa8, 0x41, 0x68, 0x31, 0xc1, 0xd1, 0x8e, 0xb2,
+  0xe5, 0x94, 0x1d, 0xe4, 0xa1, 0x32, 0x19, 0x26, 0x13, 0xbc, 0xf7, 0x5e, 0x99, 0xc1, 0x76, 0x41,
+  0x47, 0x51, 0xa4, 0xae, 0x27, 0x50, 0x04, 0x02, 0x50, 0xf5, 0xfa, 0x0a, 0x50, 0x24, 0x82, 0x52,
+  0x0d, 0x53, 0xd5, 0xef, 0xce, 0xf1, 0xa9, 0x8e, 0x59, 0xe2, 0x7e, 0xbd, 0xb8, 0xbd, 0xb9, 0xdc,
+  0x82, 0x25, 0xf4, 0x6c, 0xaa, 0x17, 0x5f, 0xb9, 0x73, 0x84, 0x8b, 0x23, 0x06, 0xe6, 0x11, 0x2d,
+  0x4f, 0x29, 0xd3, 0x40, 0x0f, 0x7e, 0xc5, 0x90, 0x24, 0xa6, 0x64, 0xfd, 0xd7, 0xc9, 0x51, 0x9b,
+  0x5f, 0x04, 0x27, 0x82, 0xaa, 0x00, 0x78, 0x5e, 0x3b, 0xbf, 0x58, 0xdd, 0xbc, 0xe6, 0xae, 0xdc,
+  0x77, 0x36, 0x96, 0x00, 0xec, 0x24, 0x26, 0x44, 0xff, 0x54, 0x39, 0xa1, 0x10, 0xb4, 0xbc, 0x32,
+  0xdd, 0xf2, 0x36, 0x33, 0xc9, 0x2a, 0xb2, 0xa8, 0x4d, 0xb2, 0x46, 0xe7, 0x27, 0xca, 0x4a, 0x5e,
+  0x89, 0xbc, 0xdf, 0x58, 0xc0, 0x94, 0x76, 0x9f, 0x3d, 0x70, 0x96, 0x57, 0xf6, 0xd0, 0x62, 0x90,
+  0xdf, 0xe8, 0x16, 0x91, 0xd4, 0x16, 0x4d, 0x9a, 0x82, 0x82, 0x55, 0x68, 0xa1, 0x12, 0x56, 0x0c,
+  0x6e, 0x6e, 0x19, 0xff, 0x7f, 0xd3, 0xe1, 0x53, 0x3c, 0x35, 0xa6, 0x4b, 0xa7, 0xb1, 0xed, 0xac,
+  0xde, 0x81, 0x7b, 0x9b, 0x79, 0xcb, 0xee, 0xc6, 0x2d, 0xf7, 0xf2, 0x85, 0xda, 0xf5, 0x55, 0x67,
+  0xe9, 0x89, 0xb3, 0x74, 0xad, 0x36, 0x77, 0x0e, 0xca, 0x02, 0xe7, 0xa7, 0xc7, 0xa0, 0x34, 0xd3,
+  0xb2, 0x7a, 0xfd, 0x07, 0x7e, 0x1a, 0x57, 0x56, 0x6a, 0x54, 0x69, 0x1f, 0xc7, 0x0b, 0x2f, 0x29,
+  0x24, 0x7a, 0xc5, 0x97, 0x41, 0x83, 0xb4, 0x85, 0x35, 0xd9, 0xa2, 0x85, 0x40, 0xde, 0x14, 0x8b,
+  0xb8, 0x2b, 0x20, 0x17, 0x32, 0x4a, 0x56, 0x01, 0x5b, 0x74, 0x84, 0xe6, 0xfa, 0x54, 0x3a, 0x15,
+  0xc0, 0xca, 0xe4, 0x0a, 0xd3, 0x4a, 0xaa, 0x9a, 0x3e, 0x10, 0x66, 0x21, 0xd7, 0xcf, 0xdf, 0x36,
+  0x40, 0x46, 0xf6, 0x0e, 0x2e, 0xd7, 0x65, 0x8a, 0x4e, 0x96, 0xad, 0x54, 0x22, 0x71, 0x68, 0x56,
+  0xd5, 0x25, 0x7a, 0x32, 0xf1, 0x02, 0x64, 0xa7, 0x1a, 0x48, 0x51, 0x49, 0xf5, 0x27, 0x13, 0x93,
+  0xfe, 0x21, 0x94, 0x2d, 0xc8, 0x85, 0x75, 0x03, 0x93, 0x4c, 0x8c, 0x19, 0x7c, 0xb6, 0xfd, 0x05,
+  0x5a, 0xb6, 0xc6, 0xf8, 0x19, 0x86, 0x32, 0xea, 0x08, 0xc4, 0x1a, 0x76, 0x32, 0x60, 0x96, 0x01,
+  0x26, 0x26, 0x96, 0x23, 0x50, 0x79, 0x85, 0x76, 0x91, 0x54, 0x9d, 0x38, 0x82, 0xb7, 0xcd, 0x81,
+  0xb7, 0x66, 0xc9, 0xed, 0xb6, 0x73, 0x97, 0x9f, 0xf8, 0xdb, 0x0d, 0x2a, 0x96, 0x54, 0xdf, 0xd1,
+  0xc7, 0x04, 0x87, 0x1c, 0x57, 0x8a, 0x58, 0x2f, 0xd9, 0xd1, 0x46, 0xbb, 0x75, 0x41, 0x59, 0xd8,
+  0xd3, 0x13, 0x4b, 0x13, 0x2e, 0xb8, 0xdf, 0x3c, 0x73, 0x36, 0xe6, 0x9c, 0xab, 0x57, 0x76, 0xe6,
+  0x9f, 0x40, 0x1a, 0x07, 0x3e, 0x06, 0xc0, 0x34, 0x2e, 0x78, 0x6c, 0x12, 0xf3, 0xc4, 0x87, 0x44,
+  0x24, 0x9b, 0xba, 0xc1, 0xd1, 0xc3, 0x5a, 0x15, 0xe1, 0xa4, 0xc5, 0x69, 0xa2, 0x17, 0x94, 0x80,
+  0x9a, 0x1d, 0x56, 0x8d, 0xdd, 0x20, 0x45, 0x6b, 0x1a, 0xa6, 0x7f, 0x3f, 0x36, 0xf2, 0x49, 0xdc,
+  0x20, 0xfd, 0x8b, 0x28, 0x5d, 0x19, 0x27, 0xc9, 0x7e, 0xc0, 0x19, 0x48, 0x48, 0x80, 0x95, 0x71,
+  0x52, 0x1e, 0xa3, 0x6c, 0x16, 0xf4, 0xe4, 0x45, 0x60, 0xc8, 0x35, 0xad, 0x82, 0x5e, 0x26, 0x56,
+  0xc1, 0x64, 0x6d, 0xe0, 0x6d, 0xee, 0xc5, 0xcd, 0x20, 0xd8, 0x34, 0x75, 0xb3, 0x01, 0x84, 0xfb,
+  0x94, 0x73, 0x6d, 0x73, 0xfb, 0xf5, 0x43, 0xe2, 0x59, 0x37, 0x16, 0x40, 0xe9, 0x21, 0x0d, 0x2e,
+  0x73, 0x45, 0x06, 0xa1, 0x8b, 0x45, 0x28, 0x69, 0x83, 0x8e, 0x5a, 0x09, 0xab, 0x5e, 0x77, 0x26,
+  0xf7, 0x6f, 0x6f, 0xaa, 0x0f, 0xd7, 0x83, 0x9e, 0x51, 0xbd, 0xf5, 0x57, 0x3f, 0x2e, 0x8c, 0x81,
+  0xb0, 0x75, 0x8a, 0x33, 0xce, 0xcb, 0x68, 0x6a, 0x26, 0xe0, 0x08, 0x0d, 0x39, 0x9e, 0xaf, 0x1d,
+  0x7d, 0xa3, 0x2e, 0xf5, 0xde, 0x45, 0xc2, 0x18, 0x33, 0x54, 0x88, 0x25, 0x14, 0x20, 0xce, 0x2e,
+  0x4d, 0x99, 0xdc, 0x9a, 0x3b, 0x5b, 0x57, 0x77, 0xee, 0x5f, 0x26, 0xd1, 0x4a, 0xa3, 0x57, 0xa5,
+  0x73, 0x6e, 0xd9, 0x7d, 0xf6, 0x2d, 0xf9, 0x9d, 0xcf, 0xfb, 0xcc, 0x79, 0x4b, 0x31, 0xa2, 0x98,
+  0x58, 0xb2, 0x9b, 0xeb, 0x53, 0xb6, 0x97, 0xec, 0xcd, 0x32, 0xc3, 0x43, 0x79, 0x55, 0x16, 0x4d,
+  0x39, 0x42, 0xf6, 0x86, 0x10, 0xbe, 0xb3, 0xf9, 0x94, 0x64, 0x58, 0xde, 0x20, 0x11, 0x60, 0x69,
+  0x91, 0x0d, 0x9e, 0x24, 0xcd, 0x03, 0x0b, 0xfb, 0x42, 0x30, 0xd6, 0x98, 0x06, 0xf1, 0xea, 0x64,
+  0x0f, 0xfd, 0x07, 0xab, 0x98, 0x49, 0xe2, 0xa4, 0xc6, 0x1c, 0x22, 0x81, 0x1d, 0x0e, 0xeb, 0x94,
+  0x85, 0x7e, 0xcd, 0x37, 0x37, 0x4a, 0x70, 0xfc, 0xd6, 0x28, 0x36, 0x01, 0x2c, 0xd6, 0x99, 0x36,
+  0x63, 0x06, 0x06, 0x9f, 0x09, 0x6b, 0x32, 0x79, 0x68, 0xb6, 0xd5, 0x36, 0x15, 0x54, 0xb2, 0x50,
+  0xf4, 0xd0, 0x2c, 0xc8, 0x14, 0xb7, 0xf5, 0x13, 0xca, 0x59, 0x2c, 0x47, 0x7b, 0x63, 0x15, 0x64,
+  0x26, 0xac, 0xd8, 0x64, 0x67, 0xbb, 0x8d, 0xea, 0x96, 0xd2, 0xd6, 0x74, 0x06, 0x9f, 0x7c, 0x3b,
+  0x54, 0xdb, 0x2a, 0x9c, 0x01, 0x35, 0x95, 0xe1, 0x6d, 0x91, 0x08, 0x19, 0x4f, 0x32, 0xda, 0x84,
+  0x21, 0xe0, 0x26, 0xc3, 0xc3, 0x56, 0x53, 0x86, 0x49, 0x2f, 0x05, 0x9e, 0x5a, 0x51, 0xbf, 0xd9,
+  0xdd, 0xb8, 0xed, 0xc7, 0x14, 0x3f, 0x22, 0x91, 0x42, 0x70, 0x6e, 0xce, 0xb9, 0x7d, 0xe7, 0xa3,
+  0xf1, 0xf1, 0x51, 0x72, 0x55, 0x2d, 0x3d, 0xa0, 0x85, 0x8d, 0x26, 0x43, 0x0c, 0xe1, 0xf7, 0x84,
+  0xe7, 0x60, 0x69, 0xb8, 0x2d, 0x55, 0x95, 0x76, 0xd2, 0xbc, 0x4b, 0x8b, 0xbc, 0x05, 0xd7, 0xb6,
+  0x4c, 0x7b, 0x6f, 0xa4, 0x3d, 0x47, 0xae, 0x36, 0x18, 0xaf, 0xdf, 0x35, 0x70, 0xc9, 0xcb, 0x7a,
+  0xb9, 0xa9, 0xdc, 0xd6, 0xe4, 0x01, 0x06, 0x1a, 0xe5, 0xe0, 0x5d, 0x14, 0x9c, 0x60, 0x9f, 0x82,
+  0x3c, 0xd4, 0xf7, 0x23, 0x12, 0x1f, 0xe0, 0xb6, 0xf8, 0xe0, 0x03, 0x12, 0xbc, 0x4c, 0x2c, 0xca,
+  0x33, 0xd4, 0x77, 0x28, 0x63, 0xfd, 0x4d, 0xe2, 0x23, 0xa3, 0xc7, 0x3f, 0x09, 0x46, 0x0c, 0x58,
+  0x4b, 0xb6, 0xf0, 0xb0, 0x03, 0x81, 0xc1, 0xc4, 0x76, 0xc9, 0xf4, 0x8f, 0xad, 0x12, 0x4a, 0x8e,
+  0x82, 0x02, 0xec, 0x23, 0x2d, 0x3a, 0x18, 0xca, 0x8b, 0x5a, 0x26, 0x22, 0xad, 0x72, 0x8e, 0x50,
+  0x29, 0xf4, 0x0b, 0x57, 0xb1, 0x2c, 0xe0, 0xb1, 0xf8, 0x57, 0xbb, 0xf9, 0xb2, 0x76, 0xeb, 0x3a,
+  0xaf, 0x66, 0xc3, 0xb1, 0x0f, 0x29, 0xdc, 0xa1, 0x9a, 0x0a, 0xdb, 0x51, 0x4e, 0xc6, 0xa6, 0xaa,
+  0xd6, 0xa4, 0x87, 0xd3, 0x39, 0x8b, 0xd3, 0xef, 0x70, 0xce, 0xde, 0xe9, 0x4e, 0x92, 0xcd, 0x52,
+  0xe0, 0xe4, 0xf0, 0xa7, 0x32, 0x19, 0x56, 0xb5, 0xac, 0x68, 0x40, 0xbb, 0x38, 0x54, 0x83, 0xc7,
+  0xc9, 0xdd, 0xf5, 0xb1, 0x02, 0x3e, 0x06, 0x4e, 0x1c, 0x8d, 0x0c, 0x8e, 0x0c, 0x93, 0xf2, 0x89,
+  0x8c, 0xe9, 0xa2, 0x0c, 0xf1, 0xa4, 0xab, 0x29, 0x51, 0xe1, 0x48, 0x1c, 0x42, 0xd7, 0x68, 0x17,
+  0x2a, 0xdb, 0xd0, 0x07, 0x4d, 0xb3, 0x26, 0x2d, 0x6f, 0xcd, 0x66, 0x12, 0xac, 0xef, 0x9f, 0x21,
+  0xfd, 0x79, 0xda, 0xb4, 0x25, 0xcd, 0x2a, 0xa4, 0xc8, 0x59, 0xc1, 0xf7, 0x70, 0x08, 0xa5, 0x45,
+  0x01, 0xd1, 0xb6, 0x2e, 0x8c, 0xb2, 0x8e, 0x2f, 0x6d, 0xf8, 0x0a, 0xac, 0xb5, 0x9b, 0x51, 0xc5,
+  0x29, 0xac, 0xe6, 0xd8, 0x07, 0x01, 0x96, 0x2b, 0xd7, 0xe6, 0x2e, 0xb8, 0x97, 0xfe, 0x09, 0xb9,
+  0x5e, 0x26, 0xc1, 0x26, 0xd9, 0x42, 0x8b, 0xc6, 0x92, 0x30, 0x3a, 0x8b, 0x2f, 0x1c, 0x0a, 0xd6,
+  0xe8, 0x06, 0x3d, 0x2b, 0x6a, 0xe4, 0xac, 0x90, 0x14, 0x72, 0xce, 0xf9, 0x15, 0x06, 0x9d, 0x49,
+  0xb0, 0xb9, 0x36, 0x4b, 0xfb, 0x85, 0x5c, 0x7f, 0xf5, 0xf5, 0x97, 0xce, 0xc2, 0x97, 0x6f, 0x59,
+  0x98, 0x3c, 0x22, 0xe4, 0x92, 0x47, 0x3a, 0x5a, 0xda, 0xd7, 0x2b, 0xe4, 0xfa, 0x7a, 0x5b, 0x2d,
+  0x05, 0x13, 0x52, 0xc1, 0xf9, 0x2f, 0x9e, 0x8e, 0xb2, 0x8e, 0x3b, 0xfb, 0x21, 0x20, 0x92, 0x89,
+  0x29, 0xd2, 0xe9, 0xac, 0x40, 0x3a, 0x2a, 0x9e, 0xbe, 0xd1, 0x18, 0xa8, 0x44, 0xab, 0x68, 0x66,
+  0xaa, 0x4c, 0x82, 0x2d, 0xa7, 0xc6, 0x4f, 0x10, 0xeb, 0x37, 0xf5, 0xce, 0x43, 0x9d, 0x99, 0x3a,
+  0x8e, 0xcf, 0xe0, 0x33, 0xa2, 0x49, 0x04, 0xde, 0xb3, 0x23, 0xd3, 0x3a, 0x9c, 0x7b, 0x2c, 0x0e,
+  0xc6, 0xb5, 0x48, 0xd1, 0x4a, 0x45, 0xd0, 0x6f, 0x08, 0x62, 0x17, 0x8a, 0xd4, 0x1b, 0x35, 0x1e,
+  0xc2, 0x51, 0x52, 0xd9, 0x64, 0xf9, 0x0a, 0x9f, 0xbc, 0x41, 0x52, 0xc1, 0x73, 0x21, 0xd9, 0xc1,
+  0x87, 0x22, 0x58, 0x44, 0xd6, 0xca, 0xca, 0x19, 0x24, 0xa9, 0xa2, 0x65, 0x65, 0x05, 0xd2, 0x2b,
+  0xf5, 0x58, 0x65, 0xe4, 0x58, 0xb8, 0x18, 0x1a, 0x65, 0x5d, 0x9a, 0x14, 0xf9, 0x9e, 0x64, 0xea,
+  0xa4, 0xe9, 0x0f, 0xfc, 0xf1, 0x3b, 0xe9, 0x42, 0x8e, 0x7c, 0x72, 0x20, 0xe3, 0xf0, 0x60, 0x34,
+  0xbc, 0x3b, 0x7c, 0x6c, 0xa0, 0xd5, 0xcb, 0xf5, 0x16, 0x7a, 0x9b, 0xb7, 0x9d, 0xdb, 0xeb, 0xdb,
+  0xaf, 0x5f, 0x55, 0x2f, 0x2c, 0xb8, 0xcb, 0x4f, 0xc3, 0xaf, 0xf2, 0xe6, 0x78, 0xbb, 0xf7, 0x96,
+  0x57, 0xaa, 0xeb, 0x5b, 0x5c, 0xcb, 0xef, 0xd7, 0xdc, 0x1b, 0xcf, 0x6b, 0xf3, 0x4b, 0x61, 0x80,
+  0x50, 0x43, 0xbc, 0x25, 0x0c, 0xe7, 0x92, 0xcf, 0x9e, 0x7a, 0x65, 0x61, 0xe2, 0x7c, 0x36, 0x92,
+  0x90, 0x78, 0xb7, 0x5d, 0xc8, 0x41, 0x81, 0x58, 0x5d, 0xbe, 0xe4, 0x6f, 0xc7, 0x1a, 0xd1, 0x61,
+  0x42, 0x81, 0x71, 0x1b, 0x8d, 0x1c, 0xfc, 0x86, 0xe3, 0x19, 0xbb, 0xd0, 0x9b, 0x0b, 0x9e, 0x10,
+  0x9c, 0x4d, 0x2f, 0x9f, 0x69, 0x7d, 0x3a, 0xcc, 0xc6, 0x34, 0xae, 0x87, 0xd5, 0xf3, 0x4a, 0x09,
+  0x10, 0xae, 0x4d, 0xf1, 0xd0, 0xac, 0x31, 0x05, 0x63, 0xa1, 0xbd, 0xe1, 0x9c, 0xfc, 0x9c, 0x53,
+  0xc8, 0x75, 0xfb, 0xef, 0x41, 0x31, 0xf1, 0x1f, 0xe7, 0xea, 0xb5, 0x16, 0x4b, 0xfd, 0xb4, 0x31,
+  0xb8, 0x3c, 0xbc, 0x4d, 0x6d, 0xee, 0xae, 0xb3, 0xfe, 0x5d, 0xab, 0x6d, 0x48, 0x92, 0x16, 0xda,
+  0x66, 0x7b, 0x13, 0x8a, 0xff, 0xd5, 0x16, 0x4b, 0xbd, 0x0c, 0xab, 0xe5, 0x2e, 0xbe, 0xc9, 0x5b,
+  0x9c, 0x64, 0xc8, 0xcd, 0x20, 0x43, 0x23, 0xfe, 0x45, 0x11, 0x13, 0x24, 0x5d, 0x83, 0xb8, 0x40,
+  0x4a, 0xa4, 0x35, 0x76, 0x10, 0xc1, 0x63, 0x7c, 0x2b, 0x14, 0x24, 0xd6, 0x01, 0x2c, 0xf8, 0x45,
+  0xc0, 0xce, 0xbf, 0xa8, 0xdd, 0x7c, 0xb6, 0x7f, 0x30, 0xc8, 0xae, 0x03, 0x60, 0x72, 0x3d, 0x13,
+  0xf7, 0xe2, 0x16, 0x27, 0x0a, 0x3d, 0x84, 0xfd, 0x00, 0x97, 0x8c, 0x00, 0xae, 0x45, 0xcc, 0x3d,
+  0x01, 0x43, 0x04, 0xf6, 0xe2, 0x3d, 0x38, 0x96, 0x7d, 0xc9, 0x08, 0x99, 0x59, 0x10, 0x4c, 0xd5,
+  0xcb, 0x13, 0x74, 0x8c, 0xa0, 0xcd, 0x2f, 0xed, 0x13, 0x8d, 0x44, 0xb5, 0x20, 0x1a, 0xfc, 0x9c,
+  0x80, 0x95, 0x98, 0xa2, 0x2d, 0xde, 0xa0, 0x01, 0x8c, 0x94, 0x34, 0x0d, 0x98, 0xfe, 0x39, 0xc3,
+  0x33, 0xeb, 0xd1, 0x86, 0x3e, 0xb8, 0x52, 0xbe, 0x78, 0x69, 0x83, 0x80, 0x0c, 0x55, 0x94, 0x70,
+  0x41, 0x57, 0x65, 0x6c, 0x66, 0x85, 0x60, 0x06, 0xb3, 0xbb, 0xb1, 0xe0, 0xae, 0x7d, 0x5f, 0x7d,
+  0xfc, 0xd5, 0xee, 0xc6, 0x05, 0x01, 0x15, 0x15, 0x2d, 0x2b, 0x1c, 0xee, 0x81, 0x07, 0xf1, 0x2c,
+  0x79, 0xe8, 0x81, 0x47, 0x7e, 0x19, 0x41, 0x35, 0x5d, 0xf7, 0xbe, 0x66, 0x85, 0x02, 0xb9, 0x8d,
+  0x90, 0x63, 0xe9, 0x52, 0x70, 0x9b, 0x06, 0xe1, 0xfd, 0xc0, 0xb0, 0x8f, 0x08, 0xd1, 0xee, 0x5b,
+  0x55, 0x20, 0x5a, 0xb4, 0xb3, 0x43, 0xe8, 0x13, 0x53, 0x83, 0x31, 0x58, 0x63, 0x9c, 0x41, 0x81,
+  0x31, 0x42, 0x96, 0x48, 0x72, 0x43, 0x24, 0xfb, 0x89, 0x21, 0xc8, 0x67, 0x5e, 0xe0, 0xa3, 0xdc,
+  0xf6, 0x50, 0x1b, 0x3f, 0x86, 0xf9, 0x86, 0xe0, 0x72, 0xbe, 0x5b, 0x64, 0xe4, 0xdf, 0xa5, 0x69,
+  0x87, 0x9b, 0x5d, 0x27, 0x6d, 0x34, 0xa6, 0x9f, 0xdf, 0x99, 0xbe, 0xf5, 0x2f, 0x20, 0x2d, 0xb5,
+  0xa5, 0xed, 0xe3, 0xe5, 0x45, 0xe7, 0xe2, 0x7d, 0xe7, 0xef, 0x2b, 0x0c, 0xb3, 0x23, 0xf5, 0x82,
+  0xdf, 0x65, 0x20, 0xc4, 0xd2, 0xaf, 0x16, 0x9e, 0x48, 0xef, 0xa6, 0x1c, 0xd5, 0xaa, 0x29, 0xea,
+  0x37, 0xee, 0xdd, 0xdc, 0xc3, 0xb7, 0xcd, 0x12, 0x26, 0xfe, 0x41, 0xbb, 0xe2, 0x28, 0x84, 0xb2,
+  0xa7, 0xe7, 0x35, 0x23, 0x41, 0xf9, 0x62, 0x11, 0x28, 0xd6, 0x45, 0x6f, 0x07, 0xb5, 0x1f, 0x9d,
+  0x46, 0xc6, 0x8f, 0x21, 0x67, 0x71, 0xbe, 0xba, 0xfe, 0x78, 0x0f, 0x95, 0x1a, 0xaf, 0x55, 0xdd,
+  0x16, 0x23, 0x2c, 0x04, 0x3f, 0xbe, 0x04, 0x00, 0xde, 0xfb, 0xef, 0x26, 0x01, 0xed, 0x74, 0xd3,
+  0xee, 0xf1, 0xea, 0x1e, 0x22, 0x04, 0xfa, 0xdd, 0x42, 0xae, 0x5d, 0xdf, 0xb9, 0x85, 0x08, 0x30,
+  0x44, 0xd3, 0x75, 0x80, 0xa6, 0xff, 0x79, 0xe7, 0x67, 0xa6, 0xb5, 0xf6, 0x85, 0xd4, 0x23, 0x00,
+  0x00,
+};
+
+// ota.html: 1129 -> 640 字节 / bytes
+static const uint8_t WEB_ASSET_OTA_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x54, 0xcf, 0x4f, 0x13, 0x41,
+  0x14, 0xbe, 0xf3, 0x57, 0x3c, 0xc7, 0x03, 0x17, 0xea, 0x16, 0x0a, 0x46, 0xdb, 0xdd, 0x26, 0x04,
+  0xe5, 0x8a, 0x89, 0xf5, 0x60, 0x0c, 0x87, 0xe9, 0xee, 0xb4, 0x3b, 0x61, 0x76, 0x66, 0x9d, 0x9d,
+  0x15, 0xaa, 0x31, 0x69, 0x4c, 0x4c, 0x8d, 0x60, 0x3c, 0x68, 0x38, 0x08, 0x18, 0x31, 0x21, 0x78,
+  0x32, 0x5e, 0x24, 0xfc, 0x8a, 0xfc, 0x31, 0x76, 0xa1, 0xfc, 0x17, 0xce, 0xce, 0x74, 0xf9, 0x11,
+  0xc1, 0x78, 0x69, 0xe7, 0xcd, 0x9b, 0xf7, 0xbd, 0xef, 0x7b, 0xdf, 0xcb, 0xba, 0x37, 0xee, 0xcd,
+  0xcd, 0x34, 0x1e, 0x3f, 0xb8, 0x0f, 0xa1, 0x8a, 0x58, 0x7d, 0xc4, 0x2d, 0xfe, 0x08, 0x0e, 0xea,
+  0x23, 0x00, 0x6e, 0x44, 0x14, 0x06, 0x3f, 0xc4, 0x32, 0x21, 0xca, 0x43, 0x8f, 0x1a, 0xb3, 0xa5,
+  0x3b, 0xc8, 0x24, 0x14, 0x55, 0x8c, 0xd4, 0xe7, 0x1a, 0xd3, 0x90, 0xbd, 0xeb, 0x9d, 0xec, 0x6f,
+  0xbb, 0x8e, 0xbd, 0xc9, 0x73, 0x89, 0xea, 0xd8, 0x13, 0x40, 0x53, 0x04, 0x1d, 0x78, 0x01, 0x2d,
+  0xc1, 0x55, 0xa9, 0x85, 0x23, 0xca, 0x3a, 0x55, 0x98, 0x96, 0x14, 0xb3, 0x31, 0x48, 0x30, 0x4f,
+  0x4a, 0x09, 0x91, 0xb4, 0x55, 0x03, 0x45, 0x96, 0x54, 0x09, 0x33, 0xda, 0xe6, 0x55, 0xf0, 0x09,
+  0x57, 0x44, 0xd6, 0x20, 0xc2, 0xb2, 0x4d, 0x75, 0x3c, 0x51, 0x8e, 0x97, 0x6a, 0xf0, 0xd2, 0xc0,
+  0x85, 0xe3, 0x1a, 0xcc, 0x17, 0x4c, 0xc8, 0x2a, 0xdc, 0xac, 0x54, 0x2a, 0xc5, 0x7d, 0x5c, 0xf4,
+  0x48, 0xe8, 0x73, 0x52, 0x85, 0xf1, 0xdb, 0xe7, 0x25, 0x94, 0xc7, 0xa9, 0x7a, 0xa2, 0x3a, 0x31,
+  0xf1, 0x50, 0x8b, 0x32, 0x82, 0xe6, 0xc7, 0xa0, 0x99, 0x2a, 0x25, 0xf8, 0xd8, 0xa5, 0x5c, 0x4e,
+  0x01, 0xcd, 0x6b, 0x9c, 0x18, 0x07, 0x01, 0xe5, 0x6d, 0x8d, 0x62, 0x1a, 0x17, 0x34, 0x6c, 0x74,
+  0x4d, 0x13, 0x0b, 0xa8, 0x8b, 0x9b, 0xd8, 0x5f, 0x68, 0x4b, 0x91, 0xf2, 0xa0, 0x54, 0xd0, 0x9c,
+  0x9c, 0x99, 0x9e, 0x9d, 0x2a, 0xd7, 0x0a, 0xda, 0x8b, 0x21, 0x55, 0xa4, 0xa6, 0x07, 0x23, 0x03,
+  0xa2, 0x43, 0x2e, 0xb8, 0x8e, 0xfc, 0x54, 0x26, 0x79, 0x32, 0x16, 0xd4, 0x8a, 0xbf, 0x08, 0x5b,
+  0x0d, 0xc5, 0x33, 0x22, 0xaf, 0x01, 0x9f, 0xc2, 0xe5, 0xc9, 0xbb, 0x57, 0x69, 0x3d, 0xd3, 0xb3,
+  0x48, 0x03, 0x15, 0x56, 0xa1, 0x52, 0x3e, 0x9b, 0xa3, 0xeb, 0x0c, 0x1d, 0x72, 0x1d, 0x6b, 0xb4,
+  0x9b, 0xdb, 0x64, 0xac, 0x0b, 0xc7, 0x2f, 0x79, 0xaa, 0xc3, 0xfc, 0x36, 0xae, 0x9f, 0x76, 0x3f,
+  0x0d, 0x8e, 0x7a, 0xfd, 0x83, 0xad, 0xfe, 0xee, 0xf2, 0xf1, 0xea, 0x5e, 0x76, 0xf8, 0xbe, 0xbf,
+  0xfb, 0xb6, 0x7f, 0xf8, 0x25, 0x5b, 0xdb, 0xef, 0x1f, 0xec, 0x1c, 0xaf, 0xf6, 0xf2, 0xdf, 0x37,
+  0xab, 0xc7, 0x2b, 0xbd, 0xec, 0xbb, 0x7e, 0xb9, 0x7e, 0xf2, 0x6d, 0x39, 0x5b, 0xff, 0x91, 0x6d,
+  0x74, 0x07, 0x47, 0x6b, 0x83, 0xcd, 0x15, 0x8b, 0xf7, 0xbb, 0xfb, 0xca, 0x75, 0x62, 0xdb, 0x67,
+  0xa2, 0xfe, 0x37, 0x80, 0xee, 0x37, 0x61, 0xb2, 0x2d, 0x21, 0x23, 0xd0, 0xab, 0x17, 0x8a, 0xc0,
+  0x43, 0x0f, 0xe6, 0x1e, 0x36, 0x10, 0x60, 0x5f, 0x51, 0xc1, 0x3d, 0xe4, 0x08, 0x85, 0x9d, 0x34,
+  0x66, 0x02, 0x07, 0x08, 0x08, 0xf7, 0xad, 0xd8, 0x28, 0x65, 0x8a, 0xc6, 0x58, 0x2a, 0x27, 0x2f,
+  0x2d, 0x05, 0x58, 0x61, 0x64, 0x17, 0xd0, 0x35, 0x33, 0x81, 0x0b, 0xfe, 0x03, 0xc7, 0x91, 0x39,
+  0xcb, 0x68, 0x11, 0x4b, 0x52, 0xbc, 0x1b, 0x5a, 0x68, 0x1f, 0x26, 0x69, 0x33, 0xa2, 0x0a, 0x15,
+  0x1c, 0xf7, 0x76, 0x8a, 0x81, 0xd8, 0x57, 0x86, 0xa4, 0x69, 0x55, 0x88, 0x19, 0x4a, 0x2e, 0xc6,
+  0xf6, 0x7f, 0x32, 0x24, 0x89, 0x84, 0x22, 0x57, 0x11, 0x35, 0xe6, 0x0d, 0x89, 0xa6, 0x92, 0x21,
+  0x88, 0x19, 0xf6, 0x49, 0x28, 0x98, 0xde, 0x19, 0x0f, 0x0d, 0x7e, 0x7d, 0xc8, 0x5e, 0x6f, 0x0d,
+  0x5b, 0x9a, 0xf9, 0xd9, 0x59, 0x23, 0x90, 0xe4, 0x69, 0x4a, 0x25, 0x09, 0xfe, 0xa5, 0x29, 0x3b,
+  0xec, 0x66, 0xdb, 0xcb, 0x97, 0x09, 0x5f, 0x29, 0x6b, 0x58, 0x2d, 0xb8, 0xcf, 0xa8, 0xbf, 0xe0,
+  0x21, 0x26, 0x7c, 0x9c, 0xb3, 0xbf, 0x15, 0x4a, 0xd2, 0xf2, 0x46, 0x9d, 0x51, 0xa4, 0x65, 0x7f,
+  0xcc, 0xd6, 0x3e, 0xf7, 0x77, 0x0f, 0x4e, 0x37, 0x7f, 0x9e, 0x6e, 0x7c, 0x3d, 0x07, 0xd2, 0x27,
+  0xb3, 0x52, 0x7a, 0x16, 0xe6, 0x8b, 0xf2, 0x07, 0xf9, 0xb9, 0x55, 0xe6, 0x69, 0x04, 0x00, 0x00,
+};
+
+// clients.html: 3054 -> 1287 字节 / bytes
+static const uint8_t WEB_ASSET_CLIENTS_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x56, 0x5b, 0x6f, 0x1b, 0x45,
+  0x14, 0x7e, 0xef, 0xaf, 0x38, 0xb8, 0x82, 0x5d, 0x0b, 0xaf, 0xd7, 0x2e, 0x0d, 0x0a, 0xf6, 0xda,
+  0x28, 0xa4, 0x29, 0x8a, 0xd4, 0x2a, 0x11, 0x04, 0x89, 0x8b, 0x10, 0x9a, 0xec, 0x8c, 0xbd, 0x43,
+  0xd7, 0x3b, 0xd6, 0xcc, 0x38, 0x17, 0xda, 0x48, 0xe5, 0x01, 0x88, 0xca, 0xf5, 0x01, 0x89, 0x07,
+  0x08, 0x22, 0x08, 0xa9, 0x08, 0x2a, 0x5a, 0x1e, 0x40, 0x91, 0xa0, 0xf4, 0xcf, 0xc4, 0x69, 0xfa,
+  0xc4, 0x5f, 0xe8, 0x99, 0xdd, 0xf1, 0x7a, 0xd7, 0x49, 0xda, 0xb6, 0x55, 0xbd, 0x73, 0xe6, 0x9c,
+  0xef, 0x7c, 0xe7, 0x32, 0x67, 0x26, 0x78, 0xee, 0xd2, 0xca, 0xe2, 0xda, 0x3b, 0xab, 0x4b, 0x10,
+  0xe9, 0x41, 0xdc, 0x3d, 0x17, 0x4c, 0x7e, 0x18, 0xa1, 0xdd, 0x73, 0x00, 0xc1, 0x80, 0x69, 0x02,
+  0x61, 0x44, 0xa4, 0x62, 0xba, 0x53, 0x79, 0x6b, 0xed, 0xb2, 0x37, 0x5f, 0x49, 0x37, 0x34, 0xd7,
+  0x31, 0xeb, 0x1e, 0x7d, 0x75, 0x7b, 0xbc, 0xfb, 0xf7, 0xc3, 0xdf, 0xef, 0x1e, 0xff, 0xf1, 0xdf,
+  0xf8, 0x97, 0xcf, 0x0e, 0x1f, 0xec, 0x1f, 0x7d, 0x7c, 0x37, 0xf0, 0xb3, 0x4d, 0xa3, 0xa6, 0xf4,
+  0x76, 0xf6, 0x05, 0xb0, 0x2e, 0xe8, 0x36, 0x5c, 0x87, 0x9e, 0x48, 0xb4, 0xd7, 0x23, 0x03, 0x1e,
+  0x6f, 0xb7, 0x60, 0x41, 0x72, 0x12, 0xd7, 0x40, 0x91, 0x44, 0x79, 0x8a, 0x49, 0xde, 0x6b, 0x83,
+  0x66, 0x5b, 0xda, 0x23, 0x31, 0xef, 0x27, 0x2d, 0x08, 0x59, 0xa2, 0x99, 0x6c, 0xc3, 0x80, 0xc8,
+  0x3e, 0xc7, 0xf5, 0x85, 0xc6, 0x70, 0xab, 0x0d, 0x3b, 0x29, 0x9c, 0x26, 0xeb, 0x31, 0x43, 0xbc,
+  0xe2, 0x1e, 0x90, 0x91, 0x16, 0x6d, 0xf4, 0x24, 0x29, 0x93, 0x5e, 0x28, 0xe2, 0x98, 0x0c, 0x15,
+  0x43, 0x1c, 0xfb, 0xd5, 0x86, 0x4d, 0x4e, 0x75, 0xd4, 0x82, 0xf9, 0xc6, 0xf3, 0x39, 0x4e, 0x54,
+  0x03, 0x4d, 0x11, 0x28, 0xb3, 0x6a, 0x41, 0x13, 0x71, 0x94, 0x88, 0x39, 0x85, 0xf3, 0x94, 0xd2,
+  0x36, 0x0c, 0x09, 0xa5, 0x3c, 0xe9, 0xa3, 0x91, 0x71, 0x7e, 0x1a, 0xbd, 0x09, 0x90, 0x01, 0x21,
+  0xe1, 0xb5, 0xbe, 0x14, 0xa3, 0x84, 0x1a, 0xf7, 0x02, 0xe1, 0xce, 0x5f, 0x5c, 0x5c, 0xb8, 0x3c,
+  0xd7, 0x68, 0x83, 0x5d, 0x6f, 0x46, 0x5c, 0xb3, 0xdc, 0x46, 0xb6, 0x12, 0x1d, 0x79, 0x61, 0xc4,
+  0x63, 0xea, 0xb2, 0x0d, 0x96, 0x54, 0x4f, 0xc7, 0xe8, 0x5d, 0x30, 0x7f, 0x0b, 0x56, 0x91, 0xd8,
+  0x60, 0xf2, 0x74, 0xdd, 0x94, 0x74, 0xa6, 0x58, 0x37, 0xdb, 0xde, 0xfa, 0x48, 0x6b, 0x91, 0xc0,
+  0xf5, 0x54, 0x04, 0x36, 0x61, 0x9e, 0x16, 0x43, 0x9b, 0x50, 0x2b, 0xcf, 0xe3, 0x6c, 0x9a, 0x4c,
+  0x16, 0x77, 0xd2, 0x92, 0x29, 0xfe, 0x11, 0x66, 0xb2, 0xf9, 0xf2, 0x54, 0x5c, 0x0a, 0xc8, 0xca,
+  0xce, 0x8e, 0x7f, 0xa2, 0x60, 0xb3, 0x9c, 0x88, 0x84, 0x95, 0x65, 0x9e, 0x24, 0x94, 0x8f, 0x54,
+  0x0b, 0xe6, 0xa6, 0x2e, 0xd6, 0xc5, 0x96, 0xa7, 0x22, 0x42, 0xc5, 0x66, 0x0b, 0x1a, 0x70, 0x11,
+  0x79, 0xa1, 0x7f, 0x90, 0xfd, 0x75, 0xe2, 0x36, 0x6a, 0x60, 0xff, 0xd5, 0x9b, 0xd5, 0x9c, 0xd2,
+  0x48, 0x2a, 0xe3, 0x74, 0x28, 0x78, 0x5a, 0x1a, 0x2b, 0xd6, 0x12, 0x1b, 0x8c, 0x6b, 0x2e, 0xb0,
+  0x68, 0xb3, 0x0c, 0xd1, 0xfe, 0x25, 0x55, 0x2b, 0x78, 0x4a, 0x05, 0x99, 0xe5, 0xc9, 0x2c, 0x4e,
+  0x12, 0xff, 0x84, 0x70, 0xe7, 0x48, 0xe3, 0xe2, 0x2b, 0xa7, 0x07, 0x60, 0xc8, 0xcf, 0x9f, 0x16,
+  0xc0, 0x5c, 0x75, 0xea, 0x30, 0xf0, 0xf3, 0x43, 0x13, 0xa8, 0x50, 0xf2, 0xa1, 0xce, 0xce, 0x8f,
+  0xef, 0x43, 0x7e, 0xdc, 0xc6, 0xbb, 0xdf, 0x1d, 0xef, 0xff, 0x3a, 0xde, 0xfd, 0xf4, 0xd1, 0xfe,
+  0x5f, 0xe3, 0x5b, 0x3f, 0x1d, 0xdf, 0xbf, 0xff, 0xff, 0xbf, 0x5f, 0x1c, 0xdd, 0xfd, 0x1a, 0x97,
+  0xb0, 0xba, 0xf0, 0xfa, 0xd2, 0x07, 0x6f, 0x2e, 0xbf, 0xbb, 0x04, 0x47, 0x7b, 0xfb, 0xe0, 0xc3,
+  0x15, 0x41, 0x28, 0x36, 0x27, 0x83, 0x30, 0xe6, 0xd8, 0xb0, 0x10, 0x73, 0xa5, 0xb1, 0xd8, 0x7d,
+  0x06, 0xeb, 0xdb, 0xe9, 0x6f, 0xad, 0x60, 0x82, 0x0a, 0x92, 0x33, 0x05, 0x8c, 0x84, 0x51, 0xea,
+  0x75, 0x83, 0xc8, 0xc2, 0x76, 0x07, 0xfb, 0xa2, 0x9d, 0xcb, 0x45, 0xaf, 0x87, 0x63, 0x01, 0x85,
+  0x05, 0x99, 0x16, 0x9a, 0xc4, 0x99, 0x28, 0x95, 0xf5, 0x46, 0x49, 0x68, 0x12, 0x0f, 0x31, 0xd2,
+  0x58, 0x45, 0x6f, 0x6e, 0xc2, 0x36, 0x57, 0x52, 0xc3, 0x6a, 0x9e, 0xc6, 0x1e, 0xd3, 0x61, 0xe4,
+  0x3a, 0x3e, 0x19, 0x72, 0x3f, 0x63, 0xa9, 0x5e, 0xcd, 0xc0, 0x3b, 0x0e, 0xbc, 0x08, 0xb9, 0x05,
+  0x7e, 0x3b, 0x2f, 0xc4, 0x7c, 0xc0, 0x33, 0x79, 0xce, 0xab, 0x6a, 0x71, 0xb0, 0x56, 0x18, 0x68,
+  0xe2, 0x4e, 0x9c, 0xba, 0x92, 0xa9, 0xa1, 0x48, 0x14, 0x9b, 0xba, 0x4a, 0xdb, 0xc1, 0x72, 0x1c,
+  0x9a, 0xb1, 0xb6, 0x9c, 0xe8, 0x5c, 0xad, 0x6e, 0xe6, 0x1e, 0x93, 0xaa, 0xde, 0x67, 0xda, 0x75,
+  0xde, 0xf6, 0xd6, 0x8c, 0xa2, 0xb7, 0x88, 0xf5, 0xd5, 0x4e, 0x15, 0x6e, 0xdc, 0x00, 0xa7, 0xe1,
+  0xd4, 0xf0, 0x7c, 0xe4, 0xfd, 0x66, 0xfe, 0x48, 0xa6, 0x47, 0x32, 0x81, 0x1c, 0xe3, 0x43, 0x85,
+  0x8e, 0x0b, 0x1a, 0x3b, 0x67, 0xb2, 0xb3, 0xa1, 0x96, 0xc9, 0xe5, 0x49, 0xcd, 0xa3, 0x2e, 0x3a,
+  0x33, 0x29, 0x96, 0x62, 0x53, 0xe1, 0x3e, 0x15, 0xe1, 0x68, 0x80, 0xf6, 0x86, 0xec, 0x52, 0xcc,
+  0xcc, 0xe7, 0x6b, 0xdb, 0xcb, 0xd4, 0x75, 0x32, 0xd8, 0x37, 0x50, 0xcb, 0x29, 0x13, 0x45, 0x49,
+  0xdd, 0xcc, 0xaf, 0x45, 0x3c, 0xcf, 0xa6, 0x13, 0x3a, 0xe0, 0x38, 0x45, 0x05, 0xcb, 0xa7, 0xde,
+  0x13, 0x72, 0x09, 0xeb, 0x3f, 0x4b, 0xb4, 0xcc, 0xd3, 0x96, 0x5b, 0x16, 0x99, 0x84, 0x92, 0x11,
+  0xcd, 0x2c, 0x19, 0xd7, 0xd1, 0xb2, 0x4c, 0x00, 0xe0, 0xbd, 0x0c, 0xa9, 0x9e, 0x90, 0x01, 0xb6,
+  0x9d, 0x5d, 0x0c, 0x48, 0xf8, 0xfe, 0x49, 0x9f, 0x86, 0xe8, 0xac, 0x47, 0xeb, 0x93, 0x3e, 0xc9,
+  0x27, 0x9d, 0xf5, 0x89, 0xf5, 0xa6, 0x33, 0x61, 0x9b, 0xd5, 0x09, 0x25, 0x59, 0x27, 0xc3, 0x21,
+  0x4b, 0xe8, 0x62, 0x3a, 0x8c, 0x35, 0x9d, 0x81, 0xd9, 0x99, 0x59, 0xa7, 0xd9, 0x2c, 0x59, 0xc8,
+  0x92, 0x46, 0x59, 0xdf, 0xf0, 0x36, 0x67, 0xcd, 0x14, 0xee, 0x2a, 0xd1, 0x11, 0x06, 0xbd, 0xe5,
+  0x36, 0x6b, 0xd9, 0x77, 0xc8, 0x78, 0xec, 0x66, 0x4d, 0xe9, 0x17, 0x9a, 0xba, 0x04, 0x70, 0x66,
+  0xb5, 0x0d, 0xea, 0x72, 0xd2, 0x13, 0x4e, 0xb5, 0x1c, 0x64, 0x89, 0xac, 0xf3, 0xf0, 0xce, 0x1d,
+  0x30, 0x47, 0xc6, 0x4d, 0x1d, 0xf6, 0x62, 0x21, 0xa4, 0x6b, 0x3b, 0xad, 0xe8, 0x12, 0x35, 0x9a,
+  0xe6, 0x3f, 0x07, 0xa5, 0x46, 0x3d, 0xa3, 0x6c, 0xd6, 0x38, 0x59, 0x70, 0xc4, 0x8c, 0x3f, 0xf9,
+  0x33, 0x95, 0x67, 0x64, 0x8d, 0xfc, 0xf0, 0xe0, 0x37, 0xe7, 0xd9, 0x78, 0x4a, 0xb6, 0x61, 0xce,
+  0x3f, 0xf2, 0xa4, 0x5c, 0x99, 0xcb, 0xdb, 0x94, 0x71, 0xd2, 0xed, 0x9d, 0x7c, 0x88, 0x3c, 0x05,
+  0x26, 0xc1, 0x18, 0xcf, 0x84, 0x29, 0x8c, 0x04, 0xe8, 0x76, 0x32, 0x96, 0xc5, 0x83, 0x38, 0x19,
+  0xb2, 0xe9, 0xcf, 0x26, 0x4f, 0x70, 0x2c, 0xd7, 0xf1, 0xd6, 0x5b, 0xc2, 0x8b, 0x57, 0x5f, 0xc1,
+  0xb1, 0xc8, 0x12, 0x26, 0x5d, 0xe7, 0xd2, 0xca, 0x55, 0x9b, 0x45, 0x33, 0x3a, 0x19, 0xc5, 0x23,
+  0x9f, 0x77, 0xe5, 0xb4, 0x23, 0x9f, 0x25, 0x50, 0x91, 0x60, 0x8b, 0x87, 0xd7, 0x90, 0x60, 0x11,
+  0x60, 0x3a, 0x0a, 0xf3, 0x4e, 0xc0, 0x5b, 0xc0, 0x86, 0xe0, 0x95, 0x1a, 0x00, 0x76, 0xda, 0xe7,
+  0x9e, 0x3d, 0x21, 0x4f, 0x73, 0x77, 0x32, 0x4b, 0x45, 0x0f, 0xb9, 0xda, 0x64, 0xbc, 0x65, 0xf9,
+  0xc2, 0xeb, 0xc8, 0x5e, 0x42, 0x81, 0x9f, 0x3d, 0x0b, 0x03, 0xf3, 0x92, 0x4b, 0xaf, 0xa7, 0xa8,
+  0x79, 0xd6, 0x0b, 0x10, 0x77, 0xd2, 0x57, 0xa2, 0x29, 0x50, 0x76, 0x7d, 0x05, 0x7a, 0xf2, 0xa8,
+  0xcc, 0x56, 0xb2, 0x9b, 0x17, 0x06, 0xb7, 0xba, 0x99, 0xf9, 0xf8, 0x9b, 0x2f, 0x1f, 0xde, 0xbe,
+  0x87, 0x0f, 0xc8, 0xa8, 0xbc, 0x7b, 0x75, 0x61, 0x11, 0xc6, 0x3f, 0xdc, 0x1b, 0xef, 0xdd, 0x2c,
+  0xee, 0xe1, 0xb7, 0x45, 0x31, 0xd2, 0x1c, 0x3d, 0xd0, 0xe9, 0x53, 0x93, 0xd3, 0x4e, 0x65, 0x3a,
+  0x0a, 0x2b, 0x5d, 0xd4, 0xc9, 0x89, 0xfb, 0x39, 0xb1, 0x80, 0xf2, 0x0d, 0x6b, 0x66, 0xdf, 0x49,
+  0xc6, 0x6e, 0x52, 0xc3, 0x4a, 0xf7, 0xf0, 0xe0, 0xd6, 0xe1, 0xc1, 0x4d, 0xec, 0xfe, 0xc0, 0xcf,
+  0xf6, 0xad, 0xb2, 0x1a, 0x12, 0xab, 0x6a, 0xcf, 0x9f, 0x71, 0x60, 0x84, 0x27, 0xc1, 0x26, 0x15,
+  0x32, 0x60, 0x9f, 0x9f, 0x04, 0x0b, 0x7c, 0x4b, 0x61, 0x62, 0x13, 0xc6, 0x44, 0xa9, 0x4e, 0xa5,
+  0xf0, 0xea, 0xa8, 0x80, 0x2d, 0x6d, 0xa7, 0x12, 0x8b, 0x90, 0x98, 0xca, 0xd6, 0x23, 0xc9, 0x7a,
+  0x1d, 0xc7, 0x77, 0x2a, 0xdd, 0xe3, 0x07, 0xdf, 0x8e, 0xbf, 0xff, 0xf1, 0xf0, 0xe0, 0x1f, 0x04,
+  0x7e, 0xb4, 0xf7, 0xf3, 0x14, 0x1b, 0xbf, 0xd2, 0x80, 0xb1, 0x1c, 0xe9, 0xb3, 0xfe, 0x31, 0x2b,
+  0x27, 0xa7, 0x57, 0xee, 0x0b, 0x00, 0x00,
+};
+
+enum WebAssetId {
+  WEB_ASSET_INDEX,
+  WEB_ASSET_OTA,
+  WEB_ASSET_CLIENTS,
+  WEB_ASSET_COUNT
+};
+
+static const WebAsset WEB_ASSETS[WEB_ASSET_COUNT] = {
+  {"/", "text/html; charset=utf-8", WEB_ASSET_INDEX_GZ, sizeof(WEB_ASSET_INDEX_GZ), "\"984987446d9156a2\""},
+  {"/ota", "text/html; charset=utf-8", WEB_ASSET_OTA_GZ, sizeof(WEB_ASSET_OTA_GZ), "\"e397c4ba8f19f06e\""},
+  {"/clients", "text/html; charset=utf-8", WEB_ASSET_CLIENTS_GZ, sizeof(WEB_ASSET_CLIENTS_GZ), "\"9d699fede79b78a2\""},
+};